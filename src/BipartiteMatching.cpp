@@ -0,0 +1,86 @@
+#include "BipartiteMatching.hpp"
+#include <limits>
+
+namespace {
+
+const int UNREACHED = std::numeric_limits<int>::max();
+
+}
+
+BipartiteMatching::BipartiteMatching() {}
+
+void BipartiteMatching::reset(int leftCount, int rightCount) {
+    adjacency.assign(leftCount, std::vector<int>());
+    matchLeft.assign(leftCount, -1);
+    matchRight.assign(rightCount, -1);
+}
+
+void BipartiteMatching::addEdge(int left, int right) {
+    adjacency[left].push_back(right);
+}
+
+int BipartiteMatching::solve() {
+    int size = 0;
+    for (int match : matchLeft) {
+        if (match >= 0) size++;
+    }
+
+    while (buildLevels()) {
+        nextEdge.assign(adjacency.size(), 0);
+        for (size_t left = 0; left < adjacency.size(); ++left) {
+            if (matchLeft[left] < 0 && augment(static_cast<int>(left))) size++;
+        }
+    }
+    return size;
+}
+
+int BipartiteMatching::getMatch(int left) const {
+    return matchLeft[left];
+}
+
+int BipartiteMatching::getMatchOfRight(int right) const {
+    return matchRight[right];
+}
+
+bool BipartiteMatching::buildLevels() {
+    // Layers of left vertices by alternating distance from the free ones
+    level.assign(adjacency.size(), UNREACHED);
+    std::vector<int> queue;
+    for (size_t left = 0; left < adjacency.size(); ++left) {
+        if (matchLeft[left] < 0) {
+            level[left] = 0;
+            queue.push_back(static_cast<int>(left));
+        }
+    }
+
+    bool found = false;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int left = queue[head];
+        for (int right : adjacency[left]) {
+            int partner = matchRight[right];
+            if (partner < 0) {
+                found = true;
+            } else if (level[partner] == UNREACHED) {
+                level[partner] = level[left] + 1;
+                queue.push_back(partner);
+            }
+        }
+    }
+    return found;
+}
+
+bool BipartiteMatching::augment(int left) {
+    for (size_t& e = nextEdge[left]; e < adjacency[left].size(); ++e) {
+        int right = adjacency[left][e];
+        int partner = matchRight[right];
+        if (partner < 0 || (level[partner] == level[left] + 1 && augment(partner))) {
+            matchLeft[left] = right;
+            matchRight[right] = left;
+            ++e;
+            return true;
+        }
+    }
+    // Dead end for the rest of this phase
+    level[left] = UNREACHED;
+    return false;
+}
@@ -0,0 +1,36 @@
+#ifndef BIPARTITE_MATCHING_HPP
+#define BIPARTITE_MATCHING_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Maximum cardinality matching by Hopcroft-Karp. Each phase finds the
+// shortest augmenting paths with one BFS from the free left vertices and
+// then augments along a maximal set of vertex-disjoint ones, so at most
+// O(sqrt(V)) phases run and the whole matching takes O(E sqrt(V)).
+class BipartiteMatching {
+public:
+    BipartiteMatching();
+
+    void reset(int leftCount, int rightCount);
+    void addEdge(int left, int right);
+
+    // Returns the size of a maximum matching
+    int solve();
+
+    // Matched partner, -1 when free
+    int getMatch(int left) const;
+    int getMatchOfRight(int right) const;
+
+private:
+    std::vector<std::vector<int>> adjacency;
+    std::vector<int> matchLeft;
+    std::vector<int> matchRight;
+    std::vector<int> level;
+    std::vector<size_t> nextEdge;
+
+    bool buildLevels();
+    bool augment(int left);
+};
+
+#endif // BIPARTITE_MATCHING_HPP
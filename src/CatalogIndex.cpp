@@ -0,0 +1,194 @@
+#include "CatalogIndex.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Minutes after midnight a meeting covers, clipped to its day
+void clip(PackedTimeSlot meeting, int& start, int& end) {
+    start = std::min(meeting.getStartMinute(), CatalogIndex::MINUTES_PER_DAY);
+    end = std::min(meeting.getEndMinute(), CatalogIndex::MINUTES_PER_DAY);
+}
+
+// Bits [from, to) of word w of a bit row
+uint64_t wordMask(int w, int from, int to) {
+    int lo = std::max(from - w * 64, 0);
+    int hi = std::min(to - w * 64, 64);
+    uint64_t upTo = hi == 64 ? ~uint64_t(0) : (uint64_t(1) << hi) - 1;
+    return upTo & (~uint64_t(0) << lo);
+}
+
+void setRange(uint64_t* words, int from, int to) {
+    for (int w = from / 64; from < to && w * 64 < to; ++w) {
+        words[w] |= wordMask(w, from, to);
+    }
+}
+
+bool anyInRange(const uint64_t* words, int from, int to) {
+    for (int w = from / 64; from < to && w * 64 < to; ++w) {
+        if (words[w] & wordMask(w, from, to)) return true;
+    }
+    return false;
+}
+
+// First minute at or after from, before to, whose bit equals busy; to if there is none
+int findNext(const uint64_t* words, int from, int to, bool busy) {
+    for (int w = from / 64; from < to && w * 64 < to; ++w) {
+        uint64_t bits = (busy ? words[w] : ~words[w]) & wordMask(w, from, to);
+        if (bits) return w * 64 + __builtin_ctzll(bits);
+    }
+    return to;
+}
+
+}
+
+const int CatalogIndex::DAYS;
+const int CatalogIndex::MINUTES_PER_DAY;
+const int CatalogIndex::WORDS_PER_DAY;
+const int CatalogIndex::HALF_HOURS;
+
+CatalogIndex::CatalogIndex() {}
+
+void CatalogIndex::build(const std::vector<std::shared_ptr<Section>>& sections) {
+    entries.clear();
+    timed.clear();
+    untimed.clear();
+    buckets.assign(DAYS * HALF_HOURS, std::vector<int>());
+    entryOf.clear();
+    entriesOf.clear();
+
+    for (const auto& section : sections) {
+        auto pattern = section->getMeetingPattern();
+        if (!pattern) {
+            untimed.push_back(section);
+            continue;
+        }
+        Entry entry;
+        entry.first = pattern->getMeetings().front();
+        entry.pattern = pattern.get();
+        entry.section = section;
+        entries.push_back(entry);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& entry = entries[i];
+        timed.push_back(entry.section);
+        entryOf[entry.section.get()] = static_cast<int>(i);
+        entriesOf[entry.section->getCourse().get()].push_back(static_cast<int>(i));
+        for (int d = 0; d < DAYS; ++d) {
+            for (uint64_t mask = entry.pattern->getWeekMask(d); mask; mask &= mask - 1) {
+                buckets[d * HALF_HOURS + __builtin_ctzll(mask)].push_back(static_cast<int>(i));
+            }
+        }
+    }
+}
+
+std::vector<std::shared_ptr<Section>> CatalogIndex::findFitting(const Schedule& schedule, bool otherCoursesOnly) const {
+    Occupancy occupancy;
+    paint(schedule, occupancy);
+
+    auto clashes = [&occupancy](const MeetingPattern& pattern) {
+        for (PackedTimeSlot meeting : pattern.getMeetings()) {
+            // Disjoint half hours are disjoint minutes; only overlapping summaries need the exact test
+            int day = meeting.getDay();
+            if (!(MeetingPattern::halfHourMask(meeting) & occupancy.summary[day])) continue;
+            int start, end;
+            clip(meeting, start, end);
+            if (anyInRange(occupancy.minutes[day], start, end)) return true;
+        }
+        return false;
+    };
+
+    // Only sections sharing a busy half hour can clash; each is tested once however many it shares
+    std::vector<int> candidates;
+    for (int d = 0; d < DAYS; ++d) {
+        for (uint64_t mask = occupancy.summary[d]; mask; mask &= mask - 1) {
+            const std::vector<int>& bucket = buckets[d * HALF_HOURS + __builtin_ctzll(mask)];
+            candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<int> excluded;
+    for (int i : candidates) {
+        if (clashes(*entries[i].pattern)) excluded.push_back(i);
+    }
+
+    // A schedule holds a handful of sections, so plain lists beat hashing for the untimed ones
+    std::vector<const Section*> taken;
+    std::vector<const Course*> takenCourses;
+    for (const auto& section : schedule.getSections()) {
+        taken.push_back(section.get());
+        auto own = entryOf.find(section.get());
+        if (own != entryOf.end()) excluded.push_back(own->second);
+        if (!otherCoursesOnly) continue;
+
+        const Course* course = section->getCourse().get();
+        takenCourses.push_back(course);
+        auto siblings = entriesOf.find(course);
+        if (siblings != entriesOf.end()) {
+            excluded.insert(excluded.end(), siblings->second.begin(), siblings->second.end());
+        }
+    }
+    std::sort(excluded.begin(), excluded.end());
+    excluded.erase(std::unique(excluded.begin(), excluded.end()), excluded.end());
+
+    // Everything between two excluded entries fits
+    std::vector<std::shared_ptr<Section>> fitting;
+    fitting.reserve(timed.size() - excluded.size() + untimed.size());
+    int from = 0;
+    for (int i : excluded) {
+        fitting.insert(fitting.end(), timed.begin() + from, timed.begin() + i);
+        from = i + 1;
+    }
+    fitting.insert(fitting.end(), timed.begin() + from, timed.end());
+
+    for (const auto& section : untimed) {
+        bool skip = std::find(taken.begin(), taken.end(), section.get()) != taken.end() ||
+                    std::find(takenCourses.begin(), takenCourses.end(), section->getCourse().get()) !=
+                        takenCourses.end();
+        if (!skip) fitting.push_back(section);
+    }
+    return fitting;
+}
+
+std::vector<TimeSlot> CatalogIndex::findFreeWindows(const Schedule& schedule, int minMinutes,
+                                                    int dayStartHour, int dayEndHour) {
+    Occupancy occupancy;
+    paint(schedule, occupancy);
+
+    int from = std::max(0, dayStartHour * 60);
+    int to = std::min(MINUTES_PER_DAY, dayEndHour * 60);
+    minMinutes = std::max(1, minMinutes);
+
+    std::vector<TimeSlot> windows;
+    for (int d = 0; d < DAYS; ++d) {
+        int minute = findNext(occupancy.minutes[d], from, to, false);
+        while (minute < to) {
+            int busy = findNext(occupancy.minutes[d], minute, to, true);
+            if (busy - minute >= minMinutes) {
+                windows.push_back(TimeSlot(static_cast<TimeSlot::Day>(d), minute / 60, minute % 60, busy - minute));
+            }
+            minute = findNext(occupancy.minutes[d], busy, to, false);
+        }
+    }
+    return windows;
+}
+
+void CatalogIndex::paint(const Schedule& schedule, Occupancy& occupancy) {
+    std::memset(&occupancy, 0, sizeof(occupancy));
+    for (const auto& section : schedule.getSections()) {
+        auto pattern = section->getMeetingPattern();
+        if (!pattern) continue;
+        for (PackedTimeSlot meeting : pattern->getMeetings()) {
+            int start, end;
+            clip(meeting, start, end);
+            setRange(occupancy.minutes[meeting.getDay()], start, end);
+            occupancy.summary[meeting.getDay()] |= MeetingPattern::halfHourMask(meeting);
+        }
+    }
+}
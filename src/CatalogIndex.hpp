@@ -0,0 +1,65 @@
+#ifndef CATALOG_INDEX_HPP
+#define CATALOG_INDEX_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Answers "what fits around this schedule" over every section in the catalog.
+// Sections are kept in order of their first meeting, and every weekday half
+// hour has a bucket of the sections meeting in it. A query paints the
+// schedule into one busy bit per minute of each day plus a half-hour summary,
+// then walks only the buckets of the schedule's busy half hours: those
+// sections check their meetings against the minute bits, a word or two each,
+// and every other section fits without being looked at, so the answer is
+// copied out in runs between the few that clash or are left out. Free
+// windows are the runs of clear minute bits.
+class CatalogIndex {
+public:
+    static const int DAYS = 5;
+    static const int MINUTES_PER_DAY = 24 * 60;
+
+    CatalogIndex();
+
+    void build(const std::vector<std::shared_ptr<Section>>& sections);
+
+    // Sections that clash with nothing in the schedule, by first meeting,
+    // then those without a time. Sections already in the schedule are
+    // left out, and with otherCoursesOnly so is every section of their courses.
+    std::vector<std::shared_ptr<Section>> findFitting(const Schedule& schedule, bool otherCoursesOnly) const;
+
+    // Gaps of at least minMinutes between dayStartHour and dayEndHour on each weekday
+    static std::vector<TimeSlot> findFreeWindows(const Schedule& schedule, int minMinutes,
+                                                 int dayStartHour, int dayEndHour);
+
+private:
+    static const int WORDS_PER_DAY = (MINUTES_PER_DAY + 63) / 64;
+    static const int HALF_HOURS = MINUTES_PER_DAY / 30;
+
+    struct Entry {
+        PackedTimeSlot first;  // earliest meeting, the sort key
+        const MeetingPattern* pattern;
+        std::shared_ptr<Section> section;
+    };
+
+    // Busy minutes of one week
+    struct Occupancy {
+        uint64_t minutes[DAYS][WORDS_PER_DAY];
+        uint64_t summary[DAYS];
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::shared_ptr<Section>> timed;  // the entries' sections, so runs copy in one go
+    std::vector<std::shared_ptr<Section>> untimed;
+
+    // Entries meeting in half hour h of weekday d, in entry order, at buckets[d * HALF_HOURS + h]
+    std::vector<std::vector<int>> buckets;
+    std::unordered_map<const Section*, int> entryOf;
+    std::unordered_map<const Course*, std::vector<int>> entriesOf;
+
+    static void paint(const Schedule& schedule, Occupancy& occupancy);
+};
+
+#endif // CATALOG_INDEX_HPP
@@ -0,0 +1,115 @@
+#include "CompactnessModel.hpp"
+#include <algorithm>
+
+namespace {
+
+// Every bit from the first to the last set bit of a non-zero mask
+uint64_t spanOf(uint64_t mask) {
+    int first = __builtin_ctzll(mask);
+    int last = 63 - __builtin_clzll(mask);
+    uint64_t upTo = last == 63 ? ~uint64_t(0) : (uint64_t(1) << (last + 1)) - 1;
+    return upTo & (~uint64_t(0) << first);
+}
+
+}
+
+const int CompactnessModel::DAYS;
+const int CompactnessModel::FIRST_HOUR;
+const int CompactnessModel::MINUTES_PER_BIT;
+
+CompactnessModel::CompactnessModel() {}
+
+void CompactnessModel::setWeights(const CompactnessWeights& weights) {
+    this->weights = weights;
+}
+
+const CompactnessWeights& CompactnessModel::getWeights() const {
+    return weights;
+}
+
+bool CompactnessModel::isActive() const {
+    return weights.gapPerHour != 0.0f || weights.earlyStart != 0.0f || weights.classDay != 0.0f;
+}
+
+uint64_t CompactnessModel::toMask(const TimeSlot& slot) {
+    return toMask(slot.pack());
+}
+
+uint64_t CompactnessModel::toMask(PackedTimeSlot meeting) {
+    int start = meeting.getStartMinute() - FIRST_HOUR * 60;
+    int end = start + meeting.getDurationMinutes();
+
+    int firstBit = std::max(0, start / MINUTES_PER_BIT);
+    int endBit = std::min(64, (end + MINUTES_PER_BIT - 1) / MINUTES_PER_BIT);
+    if (end <= 0 || firstBit >= endBit) return 0;
+
+    uint64_t upTo = endBit == 64 ? ~uint64_t(0) : (uint64_t(1) << endBit) - 1;
+    return upTo & (~uint64_t(0) << firstBit);
+}
+
+void CompactnessModel::addToWeek(const MeetingPattern& pattern, uint64_t* days) {
+    for (PackedTimeSlot meeting : pattern.getMeetings()) {
+        days[meeting.getDay()] |= toMask(meeting);
+    }
+}
+
+CompactnessReport CompactnessModel::measure(const uint64_t* days) const {
+    CompactnessReport report;
+    int earlyBit = (weights.earlyStartHour - FIRST_HOUR) * 60 / MINUTES_PER_BIT;
+
+    for (int d = 0; d < DAYS; ++d) {
+        uint64_t mask = days[d];
+        if (mask == 0) {
+            report.daysOff++;
+            continue;
+        }
+
+        int spanBits = __builtin_popcountll(spanOf(mask));
+        report.spanMinutes += spanBits * MINUTES_PER_BIT;
+        report.idleMinutes += (spanBits - __builtin_popcountll(mask)) * MINUTES_PER_BIT;
+        if (__builtin_ctzll(mask) < earlyBit) report.earlyStarts++;
+    }
+
+    report.penalty = weights.gapPerHour * report.idleMinutes / 60.0f +
+                     weights.earlyStart * report.earlyStarts +
+                     weights.classDay * (DAYS - report.daysOff);
+    return report;
+}
+
+CompactnessReport CompactnessModel::measure(const Schedule& schedule) const {
+    uint64_t days[DAYS] = {0, 0, 0, 0, 0};
+    for (const auto& section : schedule.getSections()) {
+        auto pattern = section->getMeetingPattern();
+        if (pattern) addToWeek(*pattern, days);
+    }
+    return measure(days);
+}
+
+float CompactnessModel::penalty(const uint64_t* days) const {
+    return measure(days).penalty;
+}
+
+float CompactnessModel::lowerBound(const uint64_t* days, const uint64_t* reachable) const {
+    return bestCase(days, reachable).penalty;
+}
+
+CompactnessReport CompactnessModel::bestCase(const uint64_t* days, const uint64_t* reachable) const {
+    CompactnessReport report;
+    int earlyBit = (weights.earlyStartHour - FIRST_HOUR) * 60 / MINUTES_PER_BIT;
+
+    for (int d = 0; d < DAYS; ++d) {
+        uint64_t mask = days[d];
+        if (mask == 0) {
+            report.daysOff++;
+            continue;
+        }
+
+        report.idleMinutes += __builtin_popcountll(spanOf(mask) & ~mask & ~reachable[d]) * MINUTES_PER_BIT;
+        if (__builtin_ctzll(mask) < earlyBit) report.earlyStarts++;
+    }
+
+    report.penalty = weights.gapPerHour * report.idleMinutes / 60.0f +
+                     weights.earlyStart * report.earlyStarts +
+                     weights.classDay * (DAYS - report.daysOff);
+    return report;
+}
@@ -0,0 +1,66 @@
+#ifndef COMPACTNESS_MODEL_HPP
+#define COMPACTNESS_MODEL_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+
+// Non-negative penalty weights for a spread-out week; all zero turns the objective off
+struct CompactnessWeights {
+    float gapPerHour = 0.0f;   // per idle hour between two classes on the same day
+    float earlyStart = 0.0f;   // per day whose first class starts before earlyStartHour
+    int earlyStartHour = 9;
+    float classDay = 0.0f;     // per day with any class, so days off pay off
+};
+
+struct CompactnessReport {
+    int idleMinutes = 0;   // between the first and last class of each day
+    int spanMinutes = 0;   // first start to last end, summed over days
+    int daysOff = 0;
+    int earlyStarts = 0;
+    float penalty = 0.0f;
+};
+
+// Measures how compact a week is from one 64-bit occupancy mask per day.
+// Bit b stands for the quarter hour starting at 6:00 + 15 * b minutes, so a
+// mask covers 6:00 to 22:00; classes are rounded out to whole quarters and
+// clipped to that window. The first and last class of a day are ctz and clz
+// of its mask, busy time is a popcount, and idle time is the span minus the
+// busy bits, so measuring a week is a handful of bit operations.
+class CompactnessModel {
+public:
+    static const int DAYS = 5;
+    static const int FIRST_HOUR = 6;
+    static const int MINUTES_PER_BIT = 15;
+
+    CompactnessModel();
+
+    void setWeights(const CompactnessWeights& weights);
+    const CompactnessWeights& getWeights() const;
+    bool isActive() const;
+
+    static uint64_t toMask(const TimeSlot& slot);
+    static uint64_t toMask(PackedTimeSlot meeting);
+
+    // Marks every meeting of a pattern in days
+    static void addToWeek(const MeetingPattern& pattern, uint64_t* days);
+
+    // days[d] is the occupancy of weekday d
+    CompactnessReport measure(const uint64_t* days) const;
+    CompactnessReport measure(const Schedule& schedule) const;
+    float penalty(const uint64_t* days) const;
+
+    // Smallest penalty any extension of a partial week can reach, where
+    // reachable[d] holds every bit a class still to be placed could cover.
+    // Occupied days stay occupied, early starts stay early and idle bits that
+    // nothing reachable covers stay idle, so this never overestimates.
+    float lowerBound(const uint64_t* days, const uint64_t* reachable) const;
+
+    // The same bound per measure: fewest idle minutes and early starts and most
+    // days off any extension can reach, each on its own
+    CompactnessReport bestCase(const uint64_t* days, const uint64_t* reachable) const;
+
+private:
+    CompactnessWeights weights;
+};
+
+#endif // COMPACTNESS_MODEL_HPP
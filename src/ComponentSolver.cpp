@@ -0,0 +1,194 @@
+#include "ComponentSolver.hpp"
+#include "RequirementMask.hpp"
+#include "ScoreModel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <unordered_set>
+
+ComponentSolver::ComponentSolver() : courseCount(0) {}
+
+void ComponentSolver::build(const std::vector<std::shared_ptr<Course>>& courses,
+                            const std::vector<std::shared_ptr<Requirement>>& requirements,
+                            const std::vector<std::shared_ptr<Preference>>& preferences,
+                            const std::vector<std::vector<int>>& components,
+                            const std::vector<std::vector<int>>& rank) {
+    this->components.clear();
+    courseCount = courses.size();
+
+    for (const auto& courseIndices : components) {
+        Component component;
+        component.courses = courseIndices;
+
+        std::vector<std::shared_ptr<Course>> subCourses;
+        std::unordered_set<const Course*> members;
+        std::vector<std::vector<int>> subRank;
+        for (int course : courseIndices) {
+            subCourses.push_back(courses[course]);
+            members.insert(courses[course].get());
+            subRank.push_back(static_cast<size_t>(course) < rank.size() ? rank[course] : std::vector<int>());
+        }
+
+        std::vector<std::shared_ptr<Requirement>> subRequirements;
+        for (const auto& requirement : requirements) {
+            if (members.count(requirement->getCourse().get())) {
+                subRequirements.push_back(requirement);
+            }
+        }
+
+        CompiledRequirements compiled;
+        compiled.compile(subCourses, subRequirements);
+        ScoreModel scores;
+        scores.build(subCourses, preferences);
+
+        component.solver.build(subCourses, compiled, scores);
+        component.solver.setSectionOrder(subRank);
+        this->components.push_back(component);
+    }
+}
+
+SearchResult ComponentSolver::solve(size_t keep, const SearchLimits& limits) {
+    SearchResult total;
+    total.completed = true;
+    auto startTime = std::chrono::steady_clock::now();
+    keep = std::max<size_t>(1, keep);
+
+    for (auto& component : components) {
+        component.solutions.clear();
+        component.scores.clear();
+
+        // Whatever budget the earlier components left over
+        SearchLimits remaining;
+        if (limits.timeLimitSeconds > 0.0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            remaining.timeLimitSeconds = std::max(1e-6, limits.timeLimitSeconds - elapsed);
+        }
+        if (limits.nodeLimit > 0) {
+            remaining.nodeLimit = total.nodes < limits.nodeLimit ? limits.nodeLimit - total.nodes : 1;
+        }
+
+        // Keep the true top solutions: once full, only subtrees that beat the worst kept are searched
+        typedef std::pair<float, size_t> Kept;
+        std::priority_queue<Kept, std::vector<Kept>, std::greater<Kept>> worstKept;
+        std::vector<std::vector<int>> expanded;
+        SearchResult result = component.solver.search([&](const std::vector<int>& classChoice, float score) {
+            if (component.solutions.size() == keep && score <= worstKept.top().first) return true;
+
+            // Each combination of equivalent sections is a solution of its own
+            expanded.clear();
+            component.solver.expand(classChoice, keep, expanded);
+            for (const auto& choice : expanded) {
+                if (component.solutions.size() < keep) {
+                    worstKept.push(Kept(score, component.solutions.size()));
+                    component.solutions.push_back(choice);
+                    component.scores.push_back(score);
+                } else if (score > worstKept.top().first) {
+                    size_t slot = worstKept.top().second;
+                    worstKept.pop();
+                    component.solutions[slot] = choice;
+                    component.scores[slot] = score;
+                    worstKept.push(Kept(score, slot));
+                } else {
+                    break;
+                }
+            }
+
+            if (component.solutions.size() == keep) {
+                component.solver.setPruneThreshold(worstKept.top().first);
+            }
+            return true;
+        }, remaining);
+
+        // Best first, so the merge can walk down each list in order
+        std::vector<size_t> order(component.solutions.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+                         [&component](size_t a, size_t b) { return component.scores[a] > component.scores[b]; });
+        std::vector<std::vector<int>> solutions;
+        std::vector<float> scores;
+        for (size_t i : order) {
+            solutions.push_back(component.solutions[i]);
+            scores.push_back(component.scores[i]);
+        }
+        component.solutions.swap(solutions);
+        component.scores.swap(scores);
+
+        total.nodes += result.nodes;
+        total.completed = total.completed && result.completed;
+        total.bestScore += result.bestScore;
+        total.bound += result.bound;
+    }
+
+    double combinations = getCombinationCount();
+    total.solutions = combinations >= static_cast<double>(SIZE_MAX) ? SIZE_MAX : static_cast<size_t>(combinations);
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return total;
+}
+
+void ComponentSolver::merge(size_t limit,
+                            const std::function<bool(const std::vector<int>&, float)>& onSolution) const {
+    for (const auto& component : components) {
+        if (component.solutions.empty()) return;
+    }
+
+    // Best-first over rank tuples. A tuple only advances components at or after
+    // the one it last advanced, so every tuple is reached exactly once and no
+    // visited set is needed.
+    struct Node {
+        float score;
+        std::vector<size_t> ranks;
+        size_t last;
+        bool operator<(const Node& other) const { return score < other.score; }
+    };
+
+    Node first;
+    first.score = 0.0f;
+    first.ranks.assign(components.size(), 0);
+    first.last = 0;
+    for (const auto& component : components) first.score += component.scores[0];
+
+    std::priority_queue<Node> frontier;
+    frontier.push(first);
+
+    std::vector<int> choice;
+    for (size_t produced = 0; produced < limit && !frontier.empty(); ++produced) {
+        Node node = frontier.top();
+        frontier.pop();
+
+        choice.assign(courseCount, -1);
+        for (size_t c = 0; c < components.size(); ++c) {
+            const auto& local = components[c].solutions[node.ranks[c]];
+            for (size_t i = 0; i < local.size(); ++i) {
+                choice[components[c].courses[i]] = local[i];
+            }
+        }
+        if (!onSolution(choice, node.score)) return;
+
+        for (size_t c = node.last; c < components.size(); ++c) {
+            if (node.ranks[c] + 1 >= components[c].solutions.size()) continue;
+            Node next = node;
+            next.ranks[c]++;
+            next.score = 0.0f;
+            for (size_t d = 0; d < components.size(); ++d) next.score += components[d].scores[next.ranks[d]];
+            next.last = c;
+            frontier.push(next);
+        }
+    }
+}
+
+size_t ComponentSolver::getComponentCount() const {
+    return components.size();
+}
+
+const std::vector<int>& ComponentSolver::getComponentCourses(size_t component) const {
+    return components[component].courses;
+}
+
+double ComponentSolver::getCombinationCount() const {
+    double count = components.empty() ? 0.0 : 1.0;
+    for (const auto& component : components) {
+        count *= static_cast<double>(component.solutions.size());
+    }
+    return count;
+}
@@ -0,0 +1,54 @@
+#ifndef COMPONENT_SOLVER_HPP
+#define COMPONENT_SOLVER_HPP
+
+#include "Models.hpp"
+#include "ScheduleSolver.hpp"
+#include <vector>
+#include <memory>
+#include <functional>
+
+// Solves independent groups of courses separately and combines them lazily.
+// Requirements and preferences each name a single course, so two courses
+// only interact when some of their sections overlap; ScheduleSolver's
+// conflict graph splits the courses into components that never constrain
+// each other. Each component keeps its own best solutions, and the full
+// solution space is their cross product. That product is never built: the
+// best complete schedules come out of a best-first merge over the
+// per-component ranks, one at a time.
+class ComponentSolver {
+public:
+    ComponentSolver();
+
+    // components as returned by ScheduleSolver::getComponents(); rank as for setSectionOrder()
+    void build(const std::vector<std::shared_ptr<Course>>& courses,
+               const std::vector<std::shared_ptr<Requirement>>& requirements,
+               const std::vector<std::shared_ptr<Preference>>& preferences,
+               const std::vector<std::vector<int>>& components,
+               const std::vector<std::vector<int>>& rank);
+
+    // Keeps the keep best solutions of every component; the limits cover all components together
+    SearchResult solve(size_t keep, const SearchLimits& limits = SearchLimits());
+
+    // Calls onSolution with full section choices, best score first, until it
+    // returns false, limit schedules were produced or the product is exhausted
+    void merge(size_t limit, const std::function<bool(const std::vector<int>&, float)>& onSolution) const;
+
+    size_t getComponentCount() const;
+    const std::vector<int>& getComponentCourses(size_t component) const;
+
+    // Size of the cross product of the kept solutions
+    double getCombinationCount() const;
+
+private:
+    struct Component {
+        std::vector<int> courses;   // indices into the full course list
+        ScheduleSolver solver;
+        std::vector<std::vector<int>> solutions;  // section choice per local course, best first
+        std::vector<float> scores;
+    };
+
+    std::vector<Component> components;
+    size_t courseCount;
+};
+
+#endif // COMPONENT_SOLVER_HPP
@@ -0,0 +1,143 @@
+#include "ConflictExplainer.hpp"
+#include "RequirementMask.hpp"
+#include "ScoreModel.hpp"
+#include "ScheduleSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+ConflictExplainer::ConflictExplainer(const ConflictOptions& options)
+    : options(options), checks(0), exhausted(false) {}
+
+void ConflictExplainer::addCourse(std::shared_ptr<Course> course) {
+    if (std::find(courses.begin(), courses.end(), course) == courses.end()) {
+        courses.push_back(course);
+    }
+}
+
+void ConflictExplainer::addRequirement(std::shared_ptr<Requirement> requirement) {
+    if (std::find(requirements.begin(), requirements.end(), requirement) == requirements.end()) {
+        requirements.push_back(requirement);
+    }
+}
+
+ConflictExplanation ConflictExplainer::run() {
+    ConflictExplanation explanation;
+    startTime = std::chrono::steady_clock::now();
+    checks = 0;
+    exhausted = false;
+
+    std::vector<int> all;
+    for (size_t i = 0; i < courses.size() + requirements.size(); ++i) {
+        all.push_back(static_cast<int>(i));
+    }
+
+    // Not even the full set could be decided: it is the only conflict known to exist
+    bool feasible = isFeasible(all);
+    std::vector<int> conflict;
+    if (!feasible) {
+        conflict = explain(std::vector<int>(), false, all);
+    } else if (exhausted) {
+        conflict = all;
+    }
+
+    if (!conflict.empty()) {
+        explanation.feasible = false;
+        for (int item : conflict) {
+            if (static_cast<size_t>(item) < courses.size()) {
+                explanation.courses.push_back(courses[item]);
+            } else {
+                explanation.requirements.push_back(requirements[item - courses.size()]);
+            }
+        }
+    }
+
+    explanation.budgetExhausted = exhausted;
+    explanation.minimal = !exhausted;
+    explanation.checks = checks;
+    explanation.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return explanation;
+}
+
+bool ConflictExplainer::isFeasible(const std::vector<int>& items) {
+    // Whatever time is left of the whole budget, and the per-check node limit
+    SearchLimits limits;
+    limits.nodeLimit = options.nodeLimitPerCheck;
+    if (options.timeLimitSeconds > 0.0) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsed >= options.timeLimitSeconds) {
+            exhausted = true;
+            return true;
+        }
+        limits.timeLimitSeconds = options.timeLimitSeconds - elapsed;
+    }
+    checks++;
+
+    std::vector<std::shared_ptr<Course>> subsetCourses;
+    std::unordered_set<const Course*> selected;
+    for (int item : items) {
+        if (static_cast<size_t>(item) < courses.size()) {
+            subsetCourses.push_back(courses[item]);
+            selected.insert(courses[item].get());
+        }
+    }
+
+    std::vector<std::shared_ptr<Requirement>> subsetRequirements;
+    for (int item : items) {
+        if (static_cast<size_t>(item) < courses.size()) continue;
+
+        const auto& requirement = requirements[item - courses.size()];
+        const Course* course = requirement->getCourse().get();
+        if (selected.count(course)) {
+            subsetRequirements.push_back(requirement);
+        } else if (std::none_of(courses.begin(), courses.end(),
+                                [course](const std::shared_ptr<Course>& c) { return c.get() == course; })) {
+            // A requirement on a course that is not being scheduled can never hold
+            return false;
+        }
+    }
+
+    CompiledRequirements compiled;
+    compiled.compile(subsetCourses, subsetRequirements);
+    ScoreModel scores;
+    scores.build(subsetCourses, std::vector<std::shared_ptr<Preference>>());
+
+    // Any one conflict-free schedule is enough
+    ScheduleSolver solver;
+    solver.build(subsetCourses, compiled, scores);
+    SearchResult result = solver.search([](const std::vector<int>&, float) { return false; }, limits);
+    if (result.solutions == 0 && !result.completed) {
+        exhausted = true;
+        return true;
+    }
+    return result.solutions > 0;
+}
+
+std::vector<int> ConflictExplainer::explain(const std::vector<int>& background, bool backgroundChanged,
+                                            const std::vector<int>& candidates) {
+    // Whatever was just added to the background already conflicts, so nothing more is needed
+    if (backgroundChanged && !isFeasible(background)) {
+        return std::vector<int>();
+    }
+    if (candidates.size() == 1) {
+        return candidates;
+    }
+
+    size_t half = candidates.size() / 2;
+    std::vector<int> first(candidates.begin(), candidates.begin() + half);
+    std::vector<int> second(candidates.begin() + half, candidates.end());
+
+    // Conflict members from the second half, given all of the first half
+    std::vector<int> withFirst = background;
+    withFirst.insert(withFirst.end(), first.begin(), first.end());
+    std::vector<int> fromSecond = explain(withFirst, !first.empty(), second);
+
+    // Then the members of the first half needed alongside those
+    std::vector<int> withSecond = background;
+    withSecond.insert(withSecond.end(), fromSecond.begin(), fromSecond.end());
+    std::vector<int> fromFirst = explain(withSecond, !fromSecond.empty(), first);
+
+    fromFirst.insert(fromFirst.end(), fromSecond.begin(), fromSecond.end());
+    std::sort(fromFirst.begin(), fromFirst.end());
+    return fromFirst;
+}
@@ -0,0 +1,58 @@
+#ifndef CONFLICT_EXPLAINER_HPP
+#define CONFLICT_EXPLAINER_HPP
+
+#include "Models.hpp"
+#include <chrono>
+#include <vector>
+#include <memory>
+
+// Budgets for one explanation; zero means unlimited
+struct ConflictOptions {
+    double timeLimitSeconds = 0.0;  // for the whole explanation
+    size_t nodeLimitPerCheck = 0;   // search nodes for each feasibility check
+};
+
+struct ConflictExplanation {
+    bool feasible = true;  // every course can be scheduled under every requirement
+    std::vector<std::shared_ptr<Course>> courses;
+    std::vector<std::shared_ptr<Requirement>> requirements;
+    bool minimal = true;            // dropping any one member makes the rest schedulable
+    bool budgetExhausted = false;   // some check ran out of budget; the set may hold extra members
+    size_t checks = 0;     // feasibility checks spent
+    double seconds = 0.0;
+};
+
+// Explains why no schedule exists with a minimal conflicting subset of the
+// selected courses and the hard requirements: dropping any one member makes
+// the rest schedulable. Uses QuickXplain, which splits the candidates in half
+// and recurses only into halves that still hold part of the conflict, so a
+// conflict of k items among n takes O(k log(n / k)) feasibility checks.
+// A requirement only counts when its course is in the tested subset.
+// A check that runs out of budget counts as schedulable, which keeps its
+// candidates in the set: the explanation still contains a conflict but may
+// no longer be minimal, and says so.
+class ConflictExplainer {
+public:
+    ConflictExplainer(const ConflictOptions& options = ConflictOptions());
+
+    void addCourse(std::shared_ptr<Course> course);
+    void addRequirement(std::shared_ptr<Requirement> requirement);
+
+    ConflictExplanation run();
+
+private:
+    ConflictOptions options;
+    std::vector<std::shared_ptr<Course>> courses;
+    std::vector<std::shared_ptr<Requirement>> requirements;
+    size_t checks;
+    bool exhausted;
+    std::chrono::steady_clock::time_point startTime;
+
+    // Items 0 .. courses.size() - 1 are courses, the rest are requirements.
+    // Out of budget, the answer is true and exhausted is set.
+    bool isFeasible(const std::vector<int>& items);
+    std::vector<int> explain(const std::vector<int>& background, bool backgroundChanged,
+                             const std::vector<int>& candidates);
+};
+
+#endif // CONFLICT_EXPLAINER_HPP
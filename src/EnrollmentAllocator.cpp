@@ -0,0 +1,203 @@
+#include "EnrollmentAllocator.hpp"
+#include "MinCostFlow.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+namespace {
+
+bool clash(const Section& a, const Section& b) {
+    auto first = a.getMeetingPattern();
+    auto second = b.getMeetingPattern();
+    return first && second && first->overlaps(*second);
+}
+
+}
+
+EnrollmentAllocator::EnrollmentAllocator() {}
+
+size_t EnrollmentAllocator::addStudent(const std::vector<std::shared_ptr<Schedule>>& alternatives) {
+    students.push_back(alternatives);
+    return students.size() - 1;
+}
+
+size_t EnrollmentAllocator::getStudentCount() const {
+    return students.size();
+}
+
+void EnrollmentAllocator::clear() {
+    students.clear();
+}
+
+EnrollmentResult EnrollmentAllocator::run(const EnrollmentOptions& options) {
+    EnrollmentResult result;
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Number every section once and turn each student's courses into requests
+    std::vector<std::shared_ptr<Section>> sections;
+    std::unordered_map<const Section*, int> sectionIndex;
+    std::vector<Request> requests;
+    std::vector<std::vector<int>> requestsOf(students.size());
+    for (size_t s = 0; s < students.size(); ++s) {
+        std::unordered_map<const Course*, int> requestOf;
+        for (size_t rank = 0; rank < students[s].size(); ++rank) {
+            if (!students[s][rank]) continue;
+            for (const auto& section : students[s][rank]->getSections()) {
+                auto indexed = sectionIndex.emplace(section.get(), static_cast<int>(sections.size()));
+                if (indexed.second) sections.push_back(section);
+
+                auto asked = requestOf.emplace(section->getCourse().get(), static_cast<int>(requests.size()));
+                if (asked.second) {
+                    requests.push_back(Request{static_cast<int>(s), {}, {}});
+                    requestsOf[s].push_back(asked.first->second);
+                }
+
+                // Alternatives come best first, so the first rank seen is the best
+                Request& request = requests[asked.first->second];
+                if (std::find(request.sections.begin(), request.sections.end(), indexed.first->second) ==
+                    request.sections.end()) {
+                    request.sections.push_back(indexed.first->second);
+                    request.ranks.push_back(static_cast<int>(rank));
+                }
+            }
+        }
+    }
+    result.requests = requests.size();
+
+    // Seats still open; a section without a capacity can take everyone who wants it
+    std::vector<int> seats(sections.size(), 0);
+    for (const auto& request : requests) {
+        for (int section : request.sections) seats[section]++;
+    }
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i]->getCapacity() > 0) {
+            seats[i] = std::max(0, sections[i]->getCapacity() - sections[i]->getEnrolled());
+        }
+    }
+
+    // source -> request -> section -> sink
+    int source = 0;
+    int sink = 1;
+    int requestBase = 2;
+    int sectionBase = requestBase + static_cast<int>(requests.size());
+    MinCostFlow flow(sectionBase + static_cast<int>(sections.size()));
+    std::vector<std::vector<int>> edgesOf(requests.size());
+    for (size_t r = 0; r < requests.size(); ++r) {
+        flow.addEdge(source, requestBase + static_cast<int>(r), 1, 0);
+        for (size_t k = 0; k < requests[r].sections.size(); ++k) {
+            edgesOf[r].push_back(flow.addEdge(requestBase + static_cast<int>(r),
+                                              sectionBase + requests[r].sections[k], 1, requests[r].ranks[k]));
+        }
+    }
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (seats[i] > 0) flow.addEdge(sectionBase + static_cast<int>(i), sink, seats[i], 0);
+    }
+    result.phases = flow.solve(source, sink).phases;
+
+    // chosen[r] is the position in the request's section list, -1 when it got no seat
+    std::vector<int> chosen(requests.size(), -1);
+    for (size_t r = 0; r < requests.size(); ++r) {
+        for (size_t k = 0; k < edgesOf[r].size(); ++k) {
+            if (flow.getFlow(edgesOf[r][k]) > 0) {
+                chosen[r] = static_cast<int>(k);
+                seats[requests[r].sections[k]]--;
+            }
+        }
+    }
+
+    for (size_t s = 0; s < students.size(); ++s) {
+        const std::vector<int>& own = requestsOf[s];
+        bool clashes = false;
+        for (size_t a = 0; a < own.size() && !clashes; ++a) {
+            if (chosen[own[a]] < 0) continue;
+            for (size_t b = a + 1; b < own.size() && !clashes; ++b) {
+                if (chosen[own[b]] < 0) continue;
+                clashes = clash(*sections[requests[own[a]].sections[chosen[own[a]]]],
+                                *sections[requests[own[b]].sections[chosen[own[b]]]]);
+            }
+        }
+        if (!clashes) continue;
+
+        // Give the seats back, then take the best alternative that still fits whole
+        result.repaired++;
+        std::vector<int> mixed(own.size());
+        for (size_t a = 0; a < own.size(); ++a) {
+            mixed[a] = chosen[own[a]];
+            if (chosen[own[a]] >= 0) seats[requests[own[a]].sections[chosen[own[a]]]]++;
+            chosen[own[a]] = -1;
+        }
+
+        bool placed = false;
+        for (const auto& alternative : students[s]) {
+            if (!alternative || alternative->hasConflicts()) continue;
+            bool fits = true;
+            for (const auto& section : alternative->getSections()) {
+                fits = fits && seats[sectionIndex[section.get()]] > 0;
+            }
+            if (!fits) continue;
+
+            for (size_t a = 0; a < own.size(); ++a) {
+                const Request& request = requests[own[a]];
+                for (size_t k = 0; k < request.sections.size(); ++k) {
+                    const auto& section = sections[request.sections[k]];
+                    const auto& chosenSections = alternative->getSections();
+                    if (std::find(chosenSections.begin(), chosenSections.end(), section) != chosenSections.end()) {
+                        chosen[own[a]] = static_cast<int>(k);
+                        seats[request.sections[k]]--;
+                        break;
+                    }
+                }
+            }
+            placed = true;
+            break;
+        }
+        if (placed) continue;
+
+        // Nothing fits whole: keep the mix minus the seats that clash, best ranked first
+        std::vector<size_t> order(own.size());
+        for (size_t a = 0; a < own.size(); ++a) order[a] = a;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            int rankA = mixed[a] >= 0 ? requests[own[a]].ranks[mixed[a]] : -1;
+            int rankB = mixed[b] >= 0 ? requests[own[b]].ranks[mixed[b]] : -1;
+            return rankA < rankB;
+        });
+        std::vector<int> kept;
+        for (size_t a : order) {
+            if (mixed[a] < 0) continue;
+            int section = requests[own[a]].sections[mixed[a]];
+            bool free = true;
+            for (int other : kept) free = free && !clash(*sections[section], *sections[other]);
+            if (!free) continue;
+            kept.push_back(section);
+            chosen[own[a]] = mixed[a];
+            seats[section]--;
+        }
+    }
+
+    // Claim the seats; one taken meanwhile by someone outside the batch is dropped
+    result.enrollments.assign(students.size(), std::vector<std::shared_ptr<Section>>());
+    for (size_t s = 0; s < students.size(); ++s) {
+        size_t firstRank = 0;
+        for (int r : requestsOf[s]) {
+            if (chosen[r] < 0) continue;
+            const auto& section = sections[requests[r].sections[chosen[r]]];
+            if (options.commitSeats && !section->reserveSeat()) {
+                chosen[r] = -1;
+                continue;
+            }
+            result.enrollments[s].push_back(section);
+            result.placed++;
+            result.rankCost += requests[r].ranks[chosen[r]];
+            if (requests[r].ranks[chosen[r]] == 0) firstRank++;
+        }
+
+        if (result.enrollments[s].size() == requestsOf[s].size()) result.fullyPlaced++;
+        if (!students[s].empty() && students[s][0] && firstRank == result.enrollments[s].size() &&
+            firstRank == students[s][0]->getSections().size()) {
+            result.firstChoice++;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
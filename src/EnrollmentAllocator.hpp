@@ -0,0 +1,60 @@
+#ifndef ENROLLMENT_ALLOCATOR_HPP
+#define ENROLLMENT_ALLOCATOR_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+struct EnrollmentOptions {
+    bool commitSeats = true;  // claim the allocated seats on the sections
+};
+
+struct EnrollmentResult {
+    // Sections each student was placed in, in the order students were added
+    std::vector<std::vector<std::shared_ptr<Section>>> enrollments;
+
+    size_t requests = 0;     // course seats asked for, one per course in a student's alternatives
+    size_t placed = 0;
+    size_t fullyPlaced = 0;  // students with a seat in every course they asked for
+    size_t firstChoice = 0;  // students placed exactly as their first alternative
+    size_t repaired = 0;     // students whose mixed sections clashed and were placed again
+    int64_t rankCost = 0;    // sum over placed seats of the rank of the best alternative using it
+    size_t phases = 0;       // shortest path rounds of the flow
+    double seconds = 0.0;
+};
+
+// Hands out section seats to a batch of students at once. Each student
+// lists alternative schedules, best first. Every course they ask for is one
+// unit of flow from the source, through a section of that course that one of
+// their alternatives uses, into the sink with the seats left as capacity.
+// Taking a section costs the rank of the best alternative using it, so the
+// minimum cost maximum flow fills as many seats as possible and then keeps
+// students as close to their first choices as it can. The flow is found by
+// successive shortest paths with potentials.
+// Sections picked course by course can mix alternatives into a clashing
+// week; such a student instead gets the best alternative that still fits
+// whole, or else the non-clashing part of the mix.
+class EnrollmentAllocator {
+public:
+    EnrollmentAllocator();
+
+    // Alternatives best first; returns the student's index in the result
+    size_t addStudent(const std::vector<std::shared_ptr<Schedule>>& alternatives);
+    size_t getStudentCount() const;
+    void clear();
+
+    EnrollmentResult run(const EnrollmentOptions& options = EnrollmentOptions());
+
+private:
+    // One course a student asked for and the sections that would do, with their ranks
+    struct Request {
+        int student;
+        std::vector<int> sections;
+        std::vector<int> ranks;
+    };
+
+    std::vector<std::vector<std::shared_ptr<Schedule>>> students;
+};
+
+#endif // ENROLLMENT_ALLOCATOR_HPP
@@ -0,0 +1,131 @@
+#include "MeetingPattern.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const int MINUTES_PER_MASK_BIT = 30;
+const char DAY_LETTERS[][3] = {"M", "T", "W", "Th", "F"};
+
+void append(char* out, size_t capacity, size_t& length, const char* text) {
+    size_t count = std::strlen(text);
+    if (length + 1 >= capacity) return;
+    count = std::min(count, capacity - 1 - length);
+    std::memcpy(out + length, text, count);
+    length += count;
+}
+
+}
+
+const int MeetingPattern::DAYS;
+
+MeetingPattern::MeetingPattern() : dayMask(0) {
+    std::fill(weekMask, weekMask + DAYS, 0);
+}
+
+MeetingPattern::MeetingPattern(unsigned dayMask, int startMinute, int durationMinutes) : MeetingPattern() {
+    for (int d = 0; d < DAYS; ++d) {
+        if (dayMask & (1u << d)) addMeeting(PackedTimeSlot(d, startMinute, durationMinutes));
+    }
+}
+
+void MeetingPattern::addMeeting(PackedTimeSlot meeting) {
+    if (meeting.getDay() >= DAYS) return;
+    meetings.insert(std::upper_bound(meetings.begin(), meetings.end(), meeting), meeting);
+    weekMask[meeting.getDay()] |= halfHourMask(meeting);
+    dayMask |= 1u << meeting.getDay();
+}
+
+const std::vector<PackedTimeSlot>& MeetingPattern::getMeetings() const {
+    return meetings;
+}
+
+bool MeetingPattern::isEmpty() const {
+    return meetings.empty();
+}
+
+unsigned MeetingPattern::getDayMask() const {
+    return dayMask;
+}
+
+uint64_t MeetingPattern::getWeekMask(int day) const {
+    return weekMask[day];
+}
+
+bool MeetingPattern::overlaps(const MeetingPattern& other) const {
+    bool shared = false;
+    for (int d = 0; d < DAYS; ++d) {
+        shared = shared || (weekMask[d] & other.weekMask[d]) != 0;
+    }
+    if (!shared) return false;
+
+    for (PackedTimeSlot meeting : meetings) {
+        if ((weekMask[meeting.getDay()] & other.weekMask[meeting.getDay()]) && other.overlaps(meeting)) return true;
+    }
+    return false;
+}
+
+bool MeetingPattern::overlaps(PackedTimeSlot meeting) const {
+    if (meeting.getDay() >= DAYS || !(weekMask[meeting.getDay()] & halfHourMask(meeting))) return false;
+    for (PackedTimeSlot own : meetings) {
+        if (own.overlaps(meeting)) return true;
+    }
+    return false;
+}
+
+bool MeetingPattern::startsAt(PackedTimeSlot slot) const {
+    for (PackedTimeSlot meeting : meetings) {
+        if (meeting.getDay() == slot.getDay() && meeting.getStartMinute() == slot.getStartMinute()) return true;
+    }
+    return false;
+}
+
+bool MeetingPattern::operator==(const MeetingPattern& other) const {
+    return meetings == other.meetings;
+}
+
+std::string MeetingPattern::toString() const {
+    char text[256];
+    size_t length = format(text, sizeof(text));
+    return std::string(text, length);
+}
+
+size_t MeetingPattern::format(char* out, size_t capacity) const {
+    if (capacity == 0) return 0;
+    size_t length = 0;
+
+    bool sameTimes = !meetings.empty();
+    for (PackedTimeSlot meeting : meetings) {
+        sameTimes = sameTimes && meeting.getStartMinute() == meetings[0].getStartMinute() &&
+                    meeting.getDurationMinutes() == meetings[0].getDurationMinutes();
+    }
+
+    char slot[TimeFormat::CAPACITY];
+    if (sameTimes && meetings.size() > 1) {
+        for (PackedTimeSlot meeting : meetings) {
+            append(out, capacity, length, DAY_LETTERS[meeting.getDay()]);
+        }
+        append(out, capacity, length, " ");
+        // The long style without its day name
+        TimeFormat::formatSlot(meetings[0], TimeFormat::LONG, slot, sizeof(slot));
+        append(out, capacity, length, slot + 4);
+    } else {
+        for (size_t i = 0; i < meetings.size(); ++i) {
+            if (i > 0) append(out, capacity, length, ", ");
+            TimeFormat::formatSlot(meetings[i], TimeFormat::LONG, slot, sizeof(slot));
+            append(out, capacity, length, slot);
+        }
+    }
+    out[length] = '\0';
+    return length;
+}
+
+uint64_t MeetingPattern::halfHourMask(PackedTimeSlot meeting) {
+    int start = std::min(meeting.getStartMinute(), 24 * 60);
+    int end = std::min(meeting.getEndMinute(), 24 * 60);
+    if (end <= start) return 0;
+    int first = start / MINUTES_PER_MASK_BIT;
+    int last = (end - 1) / MINUTES_PER_MASK_BIT;
+    uint64_t upTo = last == 63 ? ~uint64_t(0) : (uint64_t(1) << (last + 1)) - 1;
+    return upTo & (~uint64_t(0) << first);
+}
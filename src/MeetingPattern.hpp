@@ -0,0 +1,57 @@
+#ifndef MEETING_PATTERN_HPP
+#define MEETING_PATTERN_HPP
+
+#include "PackedTimeSlot.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The weekly meetings of one section, such as MWF 10:00 or TTh 14:30,
+// scheduled and checked for clashes as a single choice. Alongside the
+// meetings it keeps a week mask: per weekday, one bit for every half hour
+// any meeting touches. Two patterns whose masks are disjoint cannot clash,
+// so most overlap tests are five ANDs; only patterns sharing a half hour
+// compare their meetings minute by minute.
+class MeetingPattern {
+public:
+    static const int DAYS = 5;
+
+    MeetingPattern();
+
+    // Same start and length on every day whose bit is set (bit 0 = Monday)
+    MeetingPattern(unsigned dayMask, int startMinute, int durationMinutes);
+
+    // Meetings are kept in day and start order
+    void addMeeting(PackedTimeSlot meeting);
+
+    const std::vector<PackedTimeSlot>& getMeetings() const;
+    bool isEmpty() const;
+
+    // Bit d set when the pattern meets on weekday d
+    unsigned getDayMask() const;
+
+    // Half-hour occupancy of weekday day, bit h covering minutes [30h, 30h + 30)
+    uint64_t getWeekMask(int day) const;
+
+    bool overlaps(const MeetingPattern& other) const;
+    bool overlaps(PackedTimeSlot meeting) const;
+
+    // Whether some meeting starts on the day and at the minute slot does
+    bool startsAt(PackedTimeSlot slot) const;
+
+    bool operator==(const MeetingPattern& other) const;
+
+    // "MWF 10:00 AM - 10:50 AM" when every meeting shares its times,
+    // otherwise the meetings one by one, separated by commas
+    std::string toString() const;
+    size_t format(char* out, size_t capacity) const;
+
+    static uint64_t halfHourMask(PackedTimeSlot meeting);
+
+private:
+    std::vector<PackedTimeSlot> meetings;
+    uint64_t weekMask[DAYS];
+    unsigned dayMask;
+};
+
+#endif // MEETING_PATTERN_HPP
@@ -0,0 +1,139 @@
+#include "MinCostFlow.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const int64_t UNREACHED = std::numeric_limits<int64_t>::max();
+
+}
+
+MinCostFlow::MinCostFlow(int nodes) {
+    reset(nodes);
+}
+
+void MinCostFlow::reset(int nodes) {
+    edges.clear();
+    initialCapacity.clear();
+    graph.assign(nodes, std::vector<int>());
+    potential.assign(nodes, 0);
+}
+
+int MinCostFlow::addNode() {
+    graph.push_back(std::vector<int>());
+    potential.push_back(0);
+    return static_cast<int>(graph.size()) - 1;
+}
+
+int MinCostFlow::getNodeCount() const {
+    return static_cast<int>(graph.size());
+}
+
+int MinCostFlow::addEdge(int from, int to, int capacity, int64_t cost) {
+    int id = static_cast<int>(edges.size());
+    edges.push_back(Edge{to, capacity, cost});
+    edges.push_back(Edge{from, 0, -cost});
+    initialCapacity.push_back(capacity);
+    initialCapacity.push_back(0);
+    graph[from].push_back(id);
+    graph[to].push_back(id + 1);
+    return id;
+}
+
+FlowResult MinCostFlow::solve(int source, int sink, int maxFlow) {
+    FlowResult result;
+    int limit = maxFlow < 0 ? std::numeric_limits<int>::max() : maxFlow;
+
+    while (result.flow < limit && updatePotentials(source, sink)) {
+        result.phases++;
+        // Every admissible path costs the same, the potential difference
+        int64_t pathCost = potential[sink] - potential[source];
+        while (result.flow < limit && buildLevels(source, sink)) {
+            nextEdge.assign(graph.size(), 0);
+            for (int pushed = push(source, sink, limit - result.flow); pushed > 0;
+                 pushed = push(source, sink, limit - result.flow)) {
+                result.flow += pushed;
+                result.cost += pathCost * pushed;
+            }
+        }
+    }
+    return result;
+}
+
+int MinCostFlow::getFlow(int edge) const {
+    return initialCapacity[edge] - edges[edge].capacity;
+}
+
+bool MinCostFlow::updatePotentials(int source, int sink) {
+    distance.assign(graph.size(), UNREACHED);
+    typedef std::pair<int64_t, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distance[source] = 0;
+    queue.push(Entry(0, source));
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        int node = top.second;
+        if (top.first > distance[node]) continue;
+
+        for (int id : graph[node]) {
+            const Edge& edge = edges[id];
+            if (edge.capacity <= 0) continue;
+            int64_t candidate = top.first + reducedCost(node, edge);
+            if (candidate < distance[edge.to]) {
+                distance[edge.to] = candidate;
+                queue.push(Entry(candidate, edge.to));
+            }
+        }
+    }
+    if (distance[sink] == UNREACHED) {
+        return false;
+    }
+
+    // Capping at the sink's distance keeps every reduced cost non-negative
+    for (size_t node = 0; node < graph.size(); ++node) {
+        potential[node] += std::min(distance[node], distance[sink]);
+    }
+    return true;
+}
+
+bool MinCostFlow::buildLevels(int source, int sink) {
+    // Breadth-first layers over residual edges of zero reduced cost
+    level.assign(graph.size(), -1);
+    std::vector<int> queue(1, source);
+    level[source] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int node = queue[head];
+        for (int id : graph[node]) {
+            const Edge& edge = edges[id];
+            if (edge.capacity > 0 && level[edge.to] < 0 && reducedCost(node, edge) == 0) {
+                level[edge.to] = level[node] + 1;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+    return level[sink] >= 0;
+}
+
+int MinCostFlow::push(int node, int sink, int limit) {
+    if (node == sink) return limit;
+    for (size_t& i = nextEdge[node]; i < graph[node].size(); ++i) {
+        int id = graph[node][i];
+        Edge& edge = edges[id];
+        if (edge.capacity <= 0 || level[edge.to] != level[node] + 1 || reducedCost(node, edge) != 0) continue;
+
+        int pushed = push(edge.to, sink, std::min(limit, edge.capacity));
+        if (pushed > 0) {
+            edge.capacity -= pushed;
+            edges[id ^ 1].capacity += pushed;
+            return pushed;
+        }
+    }
+    return 0;
+}
+
+int64_t MinCostFlow::reducedCost(int from, const Edge& edge) const {
+    return edge.cost + potential[from] - potential[edge.to];
+}
@@ -0,0 +1,60 @@
+#ifndef MIN_COST_FLOW_HPP
+#define MIN_COST_FLOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FlowResult {
+    int flow = 0;
+    int64_t cost = 0;
+    size_t phases = 0;
+};
+
+// Minimum cost flow by successive shortest paths with node potentials.
+// Each phase runs Dijkstra on costs reduced by the potentials, which stay
+// non-negative, and then pushes a blocking flow through every edge of zero
+// reduced cost, so all augmenting paths of the same length share one
+// Dijkstra. Edge costs must be non-negative.
+class MinCostFlow {
+public:
+    explicit MinCostFlow(int nodes = 0);
+
+    void reset(int nodes);
+    int addNode();
+    int getNodeCount() const;
+
+    // Returns the edge id for getFlow()
+    int addEdge(int from, int to, int capacity, int64_t cost);
+
+    // Sends up to maxFlow units, cheapest first; the result is a minimum cost
+    // flow of its size
+    FlowResult solve(int source, int sink, int maxFlow = -1);
+
+    int getFlow(int edge) const;
+
+private:
+    // Stored in pairs: edge e ^ 1 is the residual reverse of edge e
+    struct Edge {
+        int to;
+        int capacity;
+        int64_t cost;
+    };
+
+    std::vector<Edge> edges;
+    std::vector<int> initialCapacity;
+    std::vector<std::vector<int>> graph;
+    std::vector<int64_t> potential;
+
+    // Per phase: distances for Dijkstra, then levels and arc pointers for the blocking flow
+    std::vector<int64_t> distance;
+    std::vector<int> level;
+    std::vector<size_t> nextEdge;
+
+    bool updatePotentials(int source, int sink);
+    bool buildLevels(int source, int sink);
+    int push(int node, int sink, int limit);
+    int64_t reducedCost(int from, const Edge& edge) const;
+};
+
+#endif // MIN_COST_FLOW_HPP
@@ -23,37 +23,17 @@ int TimeSlot::getDurationMinutes() const {
 }
 
 std::string TimeSlot::toString() const {
-    const char* dayNames[] = {"Mon", "Tue", "Wed", "Thu", "Fri"};
-    std::stringstream ss;
-    ss << dayNames[static_cast<int>(day)] << " ";
-    
-    // Format hours in 12-hour format
-    int hour12 = (startHour > 12) ? (startHour - 12) : startHour;
-    if (hour12 == 0) hour12 = 12;
-    
-    ss << hour12 << ":";
-    if (startMinute < 10) ss << "0";
-    ss << startMinute;
-    
-    ss << (startHour >= 12 ? " PM" : " AM");
-    
-    // Calculate end time
-    int endMinute = (startMinute + durationMinutes) % 60;
-    int endHour = startHour + (startMinute + durationMinutes) / 60;
-    
-    ss << " - ";
-    
-    // Format end time
-    int endHour12 = (endHour > 12) ? (endHour - 12) : endHour;
-    if (endHour12 == 0) endHour12 = 12;
-    
-    ss << endHour12 << ":";
-    if (endMinute < 10) ss << "0";
-    ss << endMinute;
-    
-    ss << (endHour >= 12 ? " PM" : " AM");
-    
-    return ss.str();
+    char text[TimeFormat::CAPACITY];
+    size_t length = format(text, sizeof(text));
+    return std::string(text, length);
+}
+
+size_t TimeSlot::format(char* out, size_t capacity, TimeFormat::Style style) const {
+    return TimeFormat::formatSlot(pack(), style, out, capacity);
+}
+
+PackedTimeSlot TimeSlot::pack() const {
+    return PackedTimeSlot(static_cast<int>(day), startHour * 60 + startMinute, durationMinutes);
 }
 
 bool TimeSlot::overlaps(const TimeSlot& other) const {
@@ -85,12 +65,13 @@ const std::vector<std::shared_ptr<Course>>& Teacher::getCourses() const {
 }
 
 void Teacher::addCourse(std::shared_ptr<Course> course) {
-    if (std::find(courses.begin(), courses.end(), course) == courses.end()) {
+    if (courseSet.insert(course.get()).second) {
         courses.push_back(course);
     }
 }
 
 void Teacher::removeCourse(std::shared_ptr<Course> course) {
+    courseSet.erase(course.get());
     courses.erase(std::remove(courses.begin(), courses.end(), course), courses.end());
 }
 
@@ -115,19 +96,58 @@ const std::vector<std::shared_ptr<Section>>& Course::getSections() const {
 }
 
 void Course::addSection(std::shared_ptr<Section> section) {
-    if (std::find(sections.begin(), sections.end(), section) == sections.end()) {
+    if (sectionSet.insert(section.get()).second) {
         sections.push_back(section);
     }
 }
 
 void Course::removeSection(std::shared_ptr<Section> section) {
+    sectionSet.erase(section.get());
     sections.erase(std::remove(sections.begin(), sections.end(), section), sections.end());
 }
 
+// Room implementation
+Room::Room(const std::string& id, const std::string& name, int capacity)
+    : id(id), name(name), capacity(capacity) {}
+
+std::string Room::getId() const {
+    return id;
+}
+
+std::string Room::getName() const {
+    return name;
+}
+
+int Room::getCapacity() const {
+    return capacity;
+}
+
+const std::vector<std::string>& Room::getFeatures() const {
+    return features;
+}
+
+bool Room::hasFeature(const std::string& feature) const {
+    return std::find(features.begin(), features.end(), feature) != features.end();
+}
+
+void Room::addFeature(const std::string& feature) {
+    if (!hasFeature(feature)) {
+        features.push_back(feature);
+    }
+}
+
 // Section implementation
 Section::Section(const std::string& id, std::shared_ptr<Course> course, 
                  std::shared_ptr<Teacher> teacher, std::shared_ptr<TimeSlot> timeSlot)
-    : id(id), course(course), teacher(teacher), timeSlot(timeSlot) {}
+    : id(id), course(course), teacher(teacher), room(nullptr), expectedSize(0), capacity(0), enrolled(0) {
+    setTimeSlot(timeSlot);
+}
+
+Section::Section(const std::string& id, std::shared_ptr<Course> course, 
+                 std::shared_ptr<Teacher> teacher, std::shared_ptr<MeetingPattern> meetingPattern)
+    : id(id), course(course), teacher(teacher), room(nullptr), expectedSize(0), capacity(0), enrolled(0) {
+    setMeetingPattern(meetingPattern);
+}
 
 std::string Section::getId() const {
     return id;
@@ -141,16 +161,93 @@ std::shared_ptr<Teacher> Section::getTeacher() const {
     return teacher;
 }
 
+std::shared_ptr<MeetingPattern> Section::getMeetingPattern() const {
+    return meetingPattern;
+}
+
 std::shared_ptr<TimeSlot> Section::getTimeSlot() const {
     return timeSlot;
 }
 
+std::shared_ptr<Room> Section::getRoom() const {
+    return room;
+}
+
+int Section::getExpectedSize() const {
+    return expectedSize;
+}
+
+const std::vector<std::string>& Section::getRequiredFeatures() const {
+    return requiredFeatures;
+}
+
+int Section::getCapacity() const {
+    return capacity;
+}
+
+int Section::getEnrolled() const {
+    return enrolled.load(std::memory_order_relaxed);
+}
+
+bool Section::hasSeatsLeft() const {
+    return capacity <= 0 || getEnrolled() < capacity;
+}
+
+bool Section::reserveSeat() {
+    int current = enrolled.load(std::memory_order_relaxed);
+    do {
+        if (capacity > 0 && current >= capacity) return false;
+    } while (!enrolled.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+    return true;
+}
+
+void Section::releaseSeat() {
+    int current = enrolled.load(std::memory_order_relaxed);
+    while (current > 0 && !enrolled.compare_exchange_weak(current, current - 1, std::memory_order_relaxed)) {
+    }
+}
+
 void Section::setTeacher(std::shared_ptr<Teacher> teacher) {
     this->teacher = teacher;
 }
 
 void Section::setTimeSlot(std::shared_ptr<TimeSlot> timeSlot) {
     this->timeSlot = timeSlot;
+    meetingPattern = nullptr;
+    if (timeSlot) {
+        meetingPattern = std::make_shared<MeetingPattern>();
+        meetingPattern->addMeeting(timeSlot->pack());
+    }
+}
+
+void Section::setMeetingPattern(std::shared_ptr<MeetingPattern> meetingPattern) {
+    // An empty pattern leaves the section untimed, like a null time slot
+    if (meetingPattern && meetingPattern->isEmpty()) meetingPattern = nullptr;
+    this->meetingPattern = meetingPattern;
+    timeSlot = nullptr;
+    if (meetingPattern) {
+        PackedTimeSlot first = meetingPattern->getMeetings().front();
+        timeSlot = std::make_shared<TimeSlot>(static_cast<TimeSlot::Day>(first.getDay()), first.getStartHour(),
+                                              first.getStartMinute() % 60, first.getDurationMinutes());
+    }
+}
+
+void Section::setRoom(std::shared_ptr<Room> room) {
+    this->room = room;
+}
+
+void Section::setExpectedSize(int expectedSize) {
+    this->expectedSize = expectedSize;
+}
+
+void Section::setCapacity(int capacity) {
+    this->capacity = capacity;
+}
+
+void Section::addRequiredFeature(const std::string& feature) {
+    if (std::find(requiredFeatures.begin(), requiredFeatures.end(), feature) == requiredFeatures.end()) {
+        requiredFeatures.push_back(feature);
+    }
 }
 
 // TimeSlotRequirement implementation
@@ -160,9 +257,7 @@ TimeSlotRequirement::TimeSlotRequirement(std::shared_ptr<Course> course, std::sh
 bool TimeSlotRequirement::isSatisfied(const Schedule& schedule) const {
     auto sections = schedule.getSectionsForCourse(course->getCode());
     for (const auto& section : sections) {
-        if (section->getTimeSlot()->getDay() == timeSlot->getDay() &&
-            section->getTimeSlot()->getStartHour() == timeSlot->getStartHour() &&
-            section->getTimeSlot()->getStartMinute() == timeSlot->getStartMinute()) {
+        if (allowsSection(*section)) {
             return true;
         }
     }
@@ -173,6 +268,15 @@ std::string TimeSlotRequirement::getDescription() const {
     return "Course " + course->getCode() + " must be in time slot " + timeSlot->toString();
 }
 
+std::shared_ptr<Course> TimeSlotRequirement::getCourse() const {
+    return course;
+}
+
+bool TimeSlotRequirement::allowsSection(const Section& section) const {
+    auto pattern = section.getMeetingPattern();
+    return pattern && pattern->startsAt(timeSlot->pack());
+}
+
 // TeacherRequirement implementation
 TeacherRequirement::TeacherRequirement(std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher)
     : course(course), teacher(teacher) {}
@@ -180,7 +284,7 @@ TeacherRequirement::TeacherRequirement(std::shared_ptr<Course> course, std::shar
 bool TeacherRequirement::isSatisfied(const Schedule& schedule) const {
     auto sections = schedule.getSectionsForCourse(course->getCode());
     for (const auto& section : sections) {
-        if (section->getTeacher()->getId() == teacher->getId()) {
+        if (allowsSection(*section)) {
             return true;
         }
     }
@@ -191,6 +295,65 @@ std::string TeacherRequirement::getDescription() const {
     return "Course " + course->getCode() + " must be taught by " + teacher->getName();
 }
 
+std::shared_ptr<Course> TeacherRequirement::getCourse() const {
+    return course;
+}
+
+bool TeacherRequirement::allowsSection(const Section& section) const {
+    return section.getTeacher() && section.getTeacher()->getId() == teacher->getId();
+}
+
+std::shared_ptr<Teacher> TeacherRequirement::getTeacher() const {
+    return teacher;
+}
+
+// Preference implementation
+Preference::Preference(Type type, std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher, float weight)
+    : type(type), course(course), teacher(teacher), timeSlot(nullptr), weight(weight) {}
+
+Preference::Preference(Type type, std::shared_ptr<Course> course, std::shared_ptr<TimeSlot> timeSlot, float weight)
+    : type(type), course(course), teacher(nullptr), timeSlot(timeSlot), weight(weight) {}
+
+Preference::Type Preference::getType() const {
+    return type;
+}
+
+std::shared_ptr<Course> Preference::getCourse() const {
+    return course;
+}
+
+float Preference::getWeight() const {
+    return weight;
+}
+
+std::string Preference::getDescription() const {
+    std::stringstream ss;
+    ss << ((type == PREFER_TEACHER || type == PREFER_TIME_SLOT) ? "Prefer " : "Avoid ");
+    if (teacher) {
+        ss << teacher->getName();
+    } else if (timeSlot) {
+        ss << timeSlot->toString();
+    }
+    ss << " for " << course->getCode() << " (weight " << weight << ")";
+    return ss.str();
+}
+
+bool Preference::matches(const Section& section) const {
+    if (teacher) {
+        return section.getTeacher() && section.getTeacher()->getId() == teacher->getId();
+    }
+    if (timeSlot) {
+        auto pattern = section.getMeetingPattern();
+        return pattern && pattern->startsAt(timeSlot->pack());
+    }
+    return false;
+}
+
+float Preference::scoreSection(const Section& section) const {
+    bool prefer = (type == PREFER_TEACHER || type == PREFER_TIME_SLOT);
+    return (matches(section) == prefer) ? weight : 0.0f;
+}
+
 // Schedule implementation
 Schedule::Schedule() {}
 
@@ -220,8 +383,11 @@ std::vector<std::shared_ptr<Section>> Schedule::getSectionsForCourse(const std::
 
 bool Schedule::hasConflicts() const {
     for (size_t i = 0; i < sections.size(); ++i) {
+        auto pattern = sections[i]->getMeetingPattern();
+        if (!pattern) continue;
         for (size_t j = i + 1; j < sections.size(); ++j) {
-            if (sections[i]->getTimeSlot()->overlaps(*(sections[j]->getTimeSlot()))) {
+            if (sections[j]->getMeetingPattern() &&
+                pattern->overlaps(*(sections[j]->getMeetingPattern()))) {
                 return true;
             }
         }
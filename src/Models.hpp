@@ -4,13 +4,18 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <map>
 #include <set>
+#include <unordered_set>
+#include "PackedTimeSlot.hpp"
+#include "MeetingPattern.hpp"
 
 // Forward declarations
 class Course;
 class Teacher;
 class Section;
+class Room;
 class TimeSlot;
 class Requirement;
 class Schedule;
@@ -28,6 +33,11 @@ public:
     int getDurationMinutes() const;
     std::string toString() const;
     
+    // Same text as toString() written into out, without allocating; returns the length
+    size_t format(char* out, size_t capacity, TimeFormat::Style style = TimeFormat::LONG) const;
+    
+    PackedTimeSlot pack() const;
+    
     bool overlaps(const TimeSlot& other) const;
     
 private:
@@ -53,6 +63,7 @@ private:
     std::string id;
     std::string name;
     std::vector<std::shared_ptr<Course>> courses;
+    std::unordered_set<const Course*> courseSet;  // membership test for addCourse()
 };
 
 // Class representing a course
@@ -74,6 +85,27 @@ private:
     std::string name;
     int credits;
     std::vector<std::shared_ptr<Section>> sections;
+    std::unordered_set<const Section*> sectionSet;  // membership test for addSection()
+};
+
+// Class representing a room sections can be taught in
+class Room {
+public:
+    Room(const std::string& id, const std::string& name, int capacity);
+    
+    std::string getId() const;
+    std::string getName() const;
+    int getCapacity() const;
+    const std::vector<std::string>& getFeatures() const;
+    bool hasFeature(const std::string& feature) const;
+    
+    void addFeature(const std::string& feature);
+    
+private:
+    std::string id;
+    std::string name;
+    int capacity;
+    std::vector<std::string> features;
 };
 
 // Class representing a section of a course
@@ -81,20 +113,51 @@ class Section {
 public:
     Section(const std::string& id, std::shared_ptr<Course> course, 
             std::shared_ptr<Teacher> teacher, std::shared_ptr<TimeSlot> timeSlot);
+    Section(const std::string& id, std::shared_ptr<Course> course, 
+            std::shared_ptr<Teacher> teacher, std::shared_ptr<MeetingPattern> meetingPattern);
     
     std::string getId() const;
     std::shared_ptr<Course> getCourse() const;
     std::shared_ptr<Teacher> getTeacher() const;
+    
+    // Every weekly meeting of the section; null until it has a time
+    std::shared_ptr<MeetingPattern> getMeetingPattern() const;
+    
+    // The first meeting, or the only one for a section that meets once a week
     std::shared_ptr<TimeSlot> getTimeSlot() const;
+    std::shared_ptr<Room> getRoom() const;
+    
+    // What the room has to provide: seats for the expected class size and features
+    int getExpectedSize() const;
+    const std::vector<std::string>& getRequiredFeatures() const;
+    
+    // Seats students can enroll in; zero capacity means unlimited. Seats are
+    // counted atomically, so concurrent registrations can claim them safely.
+    int getCapacity() const;
+    int getEnrolled() const;
+    bool hasSeatsLeft() const;
+    bool reserveSeat();  // false when the section is full
+    void releaseSeat();
     
     void setTeacher(std::shared_ptr<Teacher> teacher);
     void setTimeSlot(std::shared_ptr<TimeSlot> timeSlot);
+    void setMeetingPattern(std::shared_ptr<MeetingPattern> meetingPattern);
+    void setRoom(std::shared_ptr<Room> room);
+    void setExpectedSize(int expectedSize);
+    void addRequiredFeature(const std::string& feature);
+    void setCapacity(int capacity);
     
 private:
     std::string id;
     std::shared_ptr<Course> course;
     std::shared_ptr<Teacher> teacher;
     std::shared_ptr<TimeSlot> timeSlot;
+    std::shared_ptr<MeetingPattern> meetingPattern;
+    std::shared_ptr<Room> room;
+    int expectedSize;
+    std::vector<std::string> requiredFeatures;
+    int capacity;
+    std::atomic<int> enrolled;
 };
 
 // Base class for requirements
@@ -103,6 +166,10 @@ public:
     virtual ~Requirement() = default;
     virtual bool isSatisfied(const Schedule& schedule) const = 0;
     virtual std::string getDescription() const = 0;
+    
+    // Per-section form used when compiling requirements into section masks
+    virtual std::shared_ptr<Course> getCourse() const = 0;
+    virtual bool allowsSection(const Section& section) const = 0;
 };
 
 // Specific time slot requirement
@@ -111,6 +178,8 @@ public:
     TimeSlotRequirement(std::shared_ptr<Course> course, std::shared_ptr<TimeSlot> timeSlot);
     bool isSatisfied(const Schedule& schedule) const override;
     std::string getDescription() const override;
+    std::shared_ptr<Course> getCourse() const override;
+    bool allowsSection(const Section& section) const override;
     
 private:
     std::shared_ptr<Course> course;
@@ -123,10 +192,39 @@ public:
     TeacherRequirement(std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher);
     bool isSatisfied(const Schedule& schedule) const override;
     std::string getDescription() const override;
+    std::shared_ptr<Course> getCourse() const override;
+    bool allowsSection(const Section& section) const override;
+    std::shared_ptr<Teacher> getTeacher() const;
+    
+private:
+    std::shared_ptr<Course> course;
+    std::shared_ptr<Teacher> teacher;
+};
+
+// Weighted soft preference: adds to a schedule's score instead of pass/fail
+class Preference {
+public:
+    enum Type { PREFER_TEACHER, AVOID_TEACHER, PREFER_TIME_SLOT, AVOID_TIME_SLOT };
+    
+    Preference(Type type, std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher, float weight);
+    Preference(Type type, std::shared_ptr<Course> course, std::shared_ptr<TimeSlot> timeSlot, float weight);
+    
+    Type getType() const;
+    std::shared_ptr<Course> getCourse() const;
+    float getWeight() const;
+    std::string getDescription() const;
+    
+    // Score earned when the given section is chosen for the course
+    float scoreSection(const Section& section) const;
     
 private:
+    Type type;
     std::shared_ptr<Course> course;
     std::shared_ptr<Teacher> teacher;
+    std::shared_ptr<TimeSlot> timeSlot;
+    float weight;
+    
+    bool matches(const Section& section) const;
 };
 
 // Class representing a complete schedule
@@ -2,7 +2,7 @@
 #include <algorithm>
 #include <queue>
 #include <map>
-#include <random>
+#include <functional>
 
 // PQNode implementation
 PQNode::PQNode(NodeType type, const std::string& label)
@@ -75,8 +75,8 @@ bool PQTree::reduce(const std::vector<std::string>& subset) {
     return true;
 }
 
-// Simple reordering implementation
-void PQTree::reorder() {
+// Simple reordering implementation, driven by the caller's random stream
+void PQTree::reorder(Random& random) {
     if (!root) return;
     
     // Function to reorder a subtree
@@ -87,14 +87,11 @@ void PQTree::reorder() {
         if (node->getType() == NodeType::P_NODE) {
             // For P-nodes, we can reorder children in any way
             auto& children = const_cast<std::vector<std::shared_ptr<PQNode>>&>(node->getChildren());
-            // Use modern C++ shuffle instead of deprecated random_shuffle
-            std::random_device rd;
-            std::mt19937 g(rd());
-            std::shuffle(children.begin(), children.end(), g);
+            random.shuffle(children);
         } else if (node->getType() == NodeType::Q_NODE) {
             // For Q-nodes, we can only reverse the order
             auto& children = const_cast<std::vector<std::shared_ptr<PQNode>>&>(node->getChildren());
-            if (rand() % 2 == 0) {
+            if (random.nextBool()) {
                 std::reverse(children.begin(), children.end());
             }
         }
@@ -1,6 +1,7 @@
 #ifndef PQTREE_HPP
 #define PQTREE_HPP
 
+#include "Random.hpp"
 #include <vector>
 #include <memory>
 #include <string>
@@ -54,7 +55,7 @@ public:
     
     // PQ Tree operations
     bool reduce(const std::vector<std::string>& subset);
-    void reorder();
+    void reorder(Random& random);
     
     // For visualization purposes
     void computeLayout();
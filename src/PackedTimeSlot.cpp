@@ -0,0 +1,83 @@
+#include "PackedTimeSlot.hpp"
+#include <cstring>
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+const char* const DAY_NAMES[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+// "h:mm" for every minute of the day on the 12-hour clock
+struct ClockTable {
+    char text[MINUTES_PER_DAY][6];
+    unsigned char length[MINUTES_PER_DAY];
+
+    ClockTable() {
+        for (int minute = 0; minute < MINUTES_PER_DAY; ++minute) {
+            int hour12 = minute / 60 % 12;
+            if (hour12 == 0) hour12 = 12;
+            char* out = text[minute];
+            int n = 0;
+            if (hour12 >= 10) out[n++] = static_cast<char>('0' + hour12 / 10);
+            out[n++] = static_cast<char>('0' + hour12 % 10);
+            out[n++] = ':';
+            out[n++] = static_cast<char>('0' + minute % 60 / 10);
+            out[n++] = static_cast<char>('0' + minute % 10);
+            out[n] = '\0';
+            length[minute] = static_cast<unsigned char>(n);
+        }
+    }
+};
+
+const ClockTable& clockTable() {
+    static const ClockTable table;
+    return table;
+}
+
+// Appends what fits, always leaving room for the terminator
+void append(char* out, size_t capacity, size_t& length, const char* text, size_t count) {
+    if (length + 1 >= capacity) return;
+    size_t room = capacity - 1 - length;
+    if (count > room) count = room;
+    std::memcpy(out + length, text, count);
+    length += count;
+}
+
+void appendClock(char* out, size_t capacity, size_t& length, int minuteOfDay, TimeFormat::Style style) {
+    int minute = ((minuteOfDay % MINUTES_PER_DAY) + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+    const ClockTable& table = clockTable();
+    append(out, capacity, length, table.text[minute], table.length[minute]);
+    if (style == TimeFormat::LONG) append(out, capacity, length, " ", 1);
+    append(out, capacity, length, minute >= 12 * 60 ? "PM" : "AM", 2);
+}
+
+}
+
+const int PackedTimeSlot::DURATION_BITS;
+const int PackedTimeSlot::START_BITS;
+const uint32_t PackedTimeSlot::DURATION_MASK;
+const uint32_t PackedTimeSlot::START_MASK;
+const size_t TimeFormat::CAPACITY;
+
+size_t TimeFormat::formatClock(int minuteOfDay, Style style, char* out, size_t capacity) {
+    if (capacity == 0) return 0;
+    size_t length = 0;
+    appendClock(out, capacity, length, minuteOfDay, style);
+    out[length] = '\0';
+    return length;
+}
+
+size_t TimeFormat::formatSlot(PackedTimeSlot slot, Style style, char* out, size_t capacity) {
+    if (capacity == 0) return 0;
+    size_t length = 0;
+    if (style == LONG) {
+        int day = slot.getDay();
+        const char* name = day < 7 ? DAY_NAMES[day] : "???";
+        append(out, capacity, length, name, 3);
+        append(out, capacity, length, " ", 1);
+    }
+    appendClock(out, capacity, length, slot.getStartMinute(), style);
+    append(out, capacity, length, " - ", 3);
+    appendClock(out, capacity, length, slot.getEndMinute(), style);
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,68 @@
+#ifndef PACKED_TIME_SLOT_HPP
+#define PACKED_TIME_SLOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// A weekly time slot packed into one 32-bit value: the duration in the low
+// 12 bits, the start as minutes after midnight in the next 11 and the day
+// (0 = Monday, as TimeSlot::Day) in the top bits. Comparing raw values
+// orders slots by day, then start, then duration. Unlike TimeSlot it is a
+// plain value, cheap to copy and to compare in hot loops.
+class PackedTimeSlot {
+public:
+    static const int DURATION_BITS = 12;
+    static const int START_BITS = 11;
+    static const uint32_t DURATION_MASK = (1u << DURATION_BITS) - 1;
+    static const uint32_t START_MASK = (1u << START_BITS) - 1;
+
+    constexpr PackedTimeSlot() : bits(0) {}
+    constexpr PackedTimeSlot(int day, int startMinute, int durationMinutes)
+        : bits((static_cast<uint32_t>(day) << (START_BITS + DURATION_BITS)) |
+               ((static_cast<uint32_t>(startMinute) & START_MASK) << DURATION_BITS) |
+               (static_cast<uint32_t>(durationMinutes) & DURATION_MASK)) {}
+
+    static constexpr PackedTimeSlot fromRaw(uint32_t raw) { return PackedTimeSlot(raw, 0); }
+    constexpr uint32_t raw() const { return bits; }
+
+    constexpr int getDay() const { return static_cast<int>(bits >> (START_BITS + DURATION_BITS)); }
+    constexpr int getStartMinute() const { return static_cast<int>((bits >> DURATION_BITS) & START_MASK); }
+    constexpr int getDurationMinutes() const { return static_cast<int>(bits & DURATION_MASK); }
+    constexpr int getEndMinute() const { return getStartMinute() + getDurationMinutes(); }
+    constexpr int getStartHour() const { return getStartMinute() / 60; }
+
+    constexpr bool overlaps(PackedTimeSlot other) const {
+        return getDay() == other.getDay() &&
+               getStartMinute() < other.getEndMinute() && other.getStartMinute() < getEndMinute();
+    }
+
+    constexpr bool operator==(PackedTimeSlot other) const { return bits == other.bits; }
+    constexpr bool operator!=(PackedTimeSlot other) const { return bits != other.bits; }
+    constexpr bool operator<(PackedTimeSlot other) const { return bits < other.bits; }
+
+private:
+    constexpr PackedTimeSlot(uint32_t raw, int) : bits(raw) {}
+
+    uint32_t bits;
+};
+
+// Formats times into caller buffers from tables built once, so drawing a
+// schedule every frame allocates nothing. Every function writes at most
+// capacity - 1 characters plus a terminating NUL and returns the length.
+class TimeFormat {
+public:
+    enum Style {
+        LONG,     // "Mon 9:00 AM - 9:50 AM", as TimeSlot::toString()
+        COMPACT   // "9:00AM - 9:50AM", for tight spaces like the schedule grid
+    };
+
+    // Large enough for any slot in either style
+    static const size_t CAPACITY = 32;
+
+    // A minute of the day on the 12-hour clock; minutes past midnight wrap around
+    static size_t formatClock(int minuteOfDay, Style style, char* out, size_t capacity);
+
+    static size_t formatSlot(PackedTimeSlot slot, Style style, char* out, size_t capacity);
+};
+
+#endif // PACKED_TIME_SLOT_HPP
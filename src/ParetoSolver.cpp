@@ -0,0 +1,242 @@
+#include "ParetoSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+const int ParetoArchive::MAX_OBJECTIVES;
+
+ParetoArchive::ParetoArchive(int objectives)
+    : objectives(std::max(1, std::min(objectives, MAX_OBJECTIVES))), nextId(0) {}
+
+void ParetoArchive::clear() {
+    values.clear();
+    ids.clear();
+    nextId = 0;
+}
+
+bool ParetoArchive::isDominated(const float* point) const {
+    size_t end = countAtLeast(point[0]);
+    for (size_t i = 0; i < end; ++i) {
+        if (dominates(&values[i * objectives], point, objectives)) return true;
+    }
+    return false;
+}
+
+int ParetoArchive::insert(const float* point) {
+    if (isDominated(point)) return -1;
+
+    // Drop what the new point dominates; all of it sits where the first objective is <= point[0]
+    size_t kept = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const float* other = &values[i * objectives];
+        if (other[0] <= point[0] && dominates(point, other, objectives)) continue;
+        if (kept != i) {
+            std::copy(other, other + objectives, &values[kept * objectives]);
+            ids[kept] = ids[i];
+        }
+        kept++;
+    }
+    ids.resize(kept);
+    values.resize(kept * objectives);
+
+    size_t position = countAtLeast(point[0]);
+    values.insert(values.begin() + position * objectives, point, point + objectives);
+    ids.insert(ids.begin() + position, nextId);
+    return static_cast<int>(nextId++);
+}
+
+size_t ParetoArchive::size() const {
+    return ids.size();
+}
+
+const float* ParetoArchive::getValues(size_t index) const {
+    return &values[index * objectives];
+}
+
+size_t ParetoArchive::getId(size_t index) const {
+    return ids[index];
+}
+
+size_t ParetoArchive::countAtLeast(float first) const {
+    // Leading points whose first objective is >= first
+    size_t lo = 0;
+    size_t hi = ids.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (values[mid * objectives] >= first) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool ParetoArchive::dominates(const float* a, const float* b, int count) {
+    // Weakly: a is at least as good everywhere, which also rejects exact repeats
+    for (int k = 0; k < count; ++k) {
+        if (a[k] < b[k]) return false;
+    }
+    return true;
+}
+
+// ParetoSolver implementation
+ParetoSolver::ParetoSolver() : infeasible(false) {}
+
+void ParetoSolver::build(const ScheduleSolver& solver) {
+    infeasible = solver.isInfeasible();
+    front.clear();
+
+    classes.clear();
+    globalIds.clear();
+    int next = 0;
+    for (size_t i = 0; i < solver.getCourseCount(); ++i) {
+        classes.push_back(solver.getClasses(i));
+        globalIds.push_back(std::vector<int>());
+        for (size_t k = 0; k < classes[i].size(); ++k) globalIds[i].push_back(next++);
+    }
+
+    // The front only ever covers the few courses of one student, so plain pairwise checks do
+    conflicts.assign(next, std::vector<int>());
+    for (size_t i = 0; i < classes.size(); ++i) {
+        for (size_t j = i + 1; j < classes.size(); ++j) {
+            for (size_t a = 0; a < classes[i].size(); ++a) {
+                for (size_t b = 0; b < classes[j].size(); ++b) {
+                    if (classes[i][a].pattern->overlaps(*classes[j][b].pattern)) {
+                        conflicts[globalIds[i][a]].push_back(globalIds[j][b]);
+                        conflicts[globalIds[j][b]].push_back(globalIds[i][a]);
+                    }
+                }
+            }
+        }
+    }
+
+    courseOrder.clear();
+    for (size_t i = 0; i < classes.size(); ++i) {
+        if (!classes[i].empty()) courseOrder.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(courseOrder.begin(), courseOrder.end(),
+                     [this](int a, int b) { return classes[a].size() < classes[b].size(); });
+}
+
+ParetoResult ParetoSolver::run(const ParetoOptions& options) {
+    ParetoResult result;
+    auto startTime = std::chrono::steady_clock::now();
+    front.clear();
+    if (infeasible) {
+        result.complete = true;
+        return result;
+    }
+
+    CompactnessWeights weights;
+    weights.earlyStartHour = options.earlyStartHour;
+    CompactnessModel model;
+    model.setWeights(weights);
+
+    int objectives = 0;
+    if (options.preferences) objectives++;
+    if (options.idleTime) objectives++;
+    if (options.earlyStarts) objectives++;
+    if (options.daysOff) objectives++;
+    ParetoArchive archive(std::max(1, objectives));
+
+    // Everything maximized; with no objective chosen every schedule ties and one is kept
+    auto toValues = [&options](float preference, const CompactnessReport& report, float* out) {
+        int k = 0;
+        if (options.preferences) out[k++] = preference;
+        if (options.idleTime) out[k++] = -static_cast<float>(report.idleMinutes);
+        if (options.earlyStarts) out[k++] = -static_cast<float>(report.earlyStarts);
+        if (options.daysOff) out[k++] = static_cast<float>(report.daysOff);
+        if (k == 0) out[k++] = 0.0f;
+    };
+
+    const int DAYS = CompactnessModel::DAYS;
+    size_t depthCount = courseOrder.size();
+    std::vector<float> suffixBest(depthCount + 1, 0.0f);
+    std::vector<std::vector<uint64_t>> reachable(depthCount + 1, std::vector<uint64_t>(DAYS, 0));
+    std::vector<std::vector<uint64_t>> classWeek(classes.size());
+    for (size_t d = depthCount; d-- > 0;) {
+        int course = courseOrder[d];
+        float best = classes[course][0].score;
+        reachable[d] = reachable[d + 1];
+        classWeek[course].assign(classes[course].size() * DAYS, 0);
+        for (size_t k = 0; k < classes[course].size(); ++k) {
+            best = std::max(best, classes[course][k].score);
+            uint64_t* week = &classWeek[course][k * DAYS];
+            CompactnessModel::addToWeek(*classes[course][k].pattern, week);
+            for (int day = 0; day < DAYS; ++day) reachable[d][day] |= week[day];
+        }
+        suffixBest[d] = suffixBest[d + 1] + best;
+    }
+
+    std::vector<ParetoPoint> candidates;
+    std::vector<int> choice(classes.size(), -1);
+    std::vector<int> blocked(conflicts.size(), 0);
+    uint64_t days[DAYS] = {0, 0, 0, 0, 0};
+    float point[ParetoArchive::MAX_OBJECTIVES];
+    bool stopped = false;
+
+    std::function<void(size_t, float)> searchFrom = [&](size_t depth, float prefix) {
+        if (depth == depthCount) {
+            CompactnessReport report = model.measure(days);
+            toValues(prefix, report, point);
+            if (archive.insert(point) >= 0) {
+                ParetoPoint found;
+                found.choice = choice;
+                found.preference = prefix;
+                found.compactness = report;
+                candidates.push_back(found);
+            }
+            return;
+        }
+
+        int course = courseOrder[depth];
+        for (size_t k = 0; k < classes[course].size() && !stopped; ++k) {
+            int id = globalIds[course][k];
+            if (blocked[id] > 0) continue;
+
+            result.nodes++;
+            if (options.timeLimitSeconds > 0.0 && (result.nodes & 1023) == 0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >
+                    options.timeLimitSeconds) {
+                stopped = true;
+                return;
+            }
+
+            uint64_t before[DAYS];
+            std::copy(days, days + DAYS, before);
+            for (int day = 0; day < DAYS; ++day) days[day] |= classWeek[course][k * DAYS + day];
+
+            // The best this subtree could do in every objective at once
+            float score = prefix + classes[course][k].score;
+            toValues(score + suffixBest[depth + 1], model.bestCase(days, reachable[depth + 1].data()), point);
+            if (!archive.isDominated(point)) {
+                choice[course] = static_cast<int>(k);
+                for (int other : conflicts[id]) blocked[other]++;
+                searchFrom(depth + 1, score);
+                for (int other : conflicts[id]) blocked[other]--;
+                choice[course] = -1;
+            }
+
+            std::copy(before, before + DAYS, days);
+        }
+    };
+    searchFrom(0, 0.0f);
+
+    // Candidates that were later dominated dropped out of the archive
+    for (size_t i = 0; i < archive.size(); ++i) {
+        front.push_back(candidates[archive.getId(i)]);
+    }
+    std::stable_sort(front.begin(), front.end(), [](const ParetoPoint& a, const ParetoPoint& b) {
+        return a.preference > b.preference;
+    });
+
+    result.points = front.size();
+    result.complete = !stopped;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+const std::vector<ParetoPoint>& ParetoSolver::getFront() const {
+    return front;
+}
@@ -0,0 +1,96 @@
+#ifndef PARETO_SOLVER_HPP
+#define PARETO_SOLVER_HPP
+
+#include "ScheduleSolver.hpp"
+#include "CompactnessModel.hpp"
+#include <vector>
+
+// Objectives a Pareto search trades off against each other instead of
+// folding them into one weighted score
+struct ParetoOptions {
+    bool preferences = true;   // higher total preference score
+    bool idleTime = true;      // fewer idle minutes between classes
+    bool earlyStarts = true;   // fewer days starting before earlyStartHour
+    bool daysOff = true;       // more days without classes
+    int earlyStartHour = 9;
+    double timeLimitSeconds = 1.0;  // zero means unlimited
+};
+
+// One schedule of the front: no other schedule is at least as good in every
+// objective and better in one
+struct ParetoPoint {
+    std::vector<int> choice;   // class index per course, as ScheduleSolver reports them
+    float preference = 0.0f;   // raw solver score
+    CompactnessReport compactness;
+};
+
+struct ParetoResult {
+    size_t points = 0;
+    size_t nodes = 0;
+    bool complete = false;  // the search finished, so the front is exact
+    double seconds = 0.0;
+};
+
+// Non-dominated objective vectors, every objective maximized. Points are kept
+// sorted by their first objective, best first: only points at least as good
+// in it can dominate a new one, and only points no better in it can be
+// dominated by it, so each test scans one side of a binary search.
+class ParetoArchive {
+public:
+    static const int MAX_OBJECTIVES = 5;
+
+    explicit ParetoArchive(int objectives = 1);
+
+    void clear();
+
+    // Whether a kept point is at least as good in every objective
+    bool isDominated(const float* values) const;
+
+    // Keeps the point unless it is dominated, dropping the points it dominates;
+    // returns where it went, or -1 when it was rejected
+    int insert(const float* values);
+
+    size_t size() const;
+    const float* getValues(size_t index) const;
+
+    // Index into the insertion order of the point at position index
+    size_t getId(size_t index) const;
+
+private:
+    int objectives;
+    std::vector<float> values;  // objectives values per point, back to back
+    std::vector<size_t> ids;
+    size_t nextId;
+
+    size_t countAtLeast(float first) const;
+    static bool dominates(const float* a, const float* b, int count);
+};
+
+// Branch and bound for the Pareto front over a built ScheduleSolver's
+// classes. Every partial schedule gets an optimistic objective vector: the
+// preference prefix plus the best remaining class scores, and the
+// compactness measures no extension can improve on. A subtree is pruned as
+// soon as a schedule already in the archive is at least as good as that
+// vector in every objective.
+class ParetoSolver {
+public:
+    ParetoSolver();
+
+    void build(const ScheduleSolver& solver);
+
+    ParetoResult run(const ParetoOptions& options);
+
+    // The front, best preference score first
+    const std::vector<ParetoPoint>& getFront() const;
+
+private:
+    std::vector<std::vector<SectionClass>> classes;
+    std::vector<std::vector<int>> globalIds;
+    std::vector<std::vector<int>> conflicts;
+    std::vector<int> courseOrder;
+    bool infeasible;
+
+    std::vector<ParetoPoint> front;
+};
+
+#endif // PARETO_SOLVER_HPP
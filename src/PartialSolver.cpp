@@ -0,0 +1,278 @@
+#include "PartialSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+
+namespace {
+
+// Placed weight first, preference score to break ties
+struct Value {
+    float weight;
+    float score;
+
+    bool operator<(const Value& other) const {
+        return weight != other.weight ? weight < other.weight : score < other.score;
+    }
+};
+
+// One course of an interval-structured group
+struct Interval {
+    int course;
+    int start;
+    int end;
+    Value value;
+};
+
+}
+
+PartialSolver::PartialSolver() {}
+
+void PartialSolver::build(const ScheduleSolver& solver, const std::vector<float>& weights) {
+    this->weights = weights;
+    this->weights.resize(solver.getCourseCount(), 0.0f);
+
+    classes.clear();
+    globalIds.clear();
+    int next = 0;
+    for (size_t i = 0; i < solver.getCourseCount(); ++i) {
+        classes.push_back(solver.getClasses(i));
+        globalIds.push_back(std::vector<int>());
+        for (size_t k = 0; k < classes[i].size(); ++k) globalIds[i].push_back(next++);
+    }
+}
+
+PartialResult PartialSolver::run(const PartialOptions& options) {
+    PartialResult result;
+    auto startTime = std::chrono::steady_clock::now();
+    result.choice.assign(classes.size(), -1);
+    for (float weight : weights) result.totalWeight += weight;
+
+    result.intervalStructured = isIntervalStructured();
+    if (result.intervalStructured) {
+        solveIntervals(result);
+    } else {
+        solveBranchAndBound(options, result);
+    }
+
+    for (size_t i = 0; i < classes.size(); ++i) {
+        if (result.choice[i] < 0) continue;
+        result.placedWeight += weights[i];
+        result.score += classes[i][result.choice[i]].score;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+bool PartialSolver::buildConflicts(size_t memoryLimitBytes, std::vector<std::vector<int>>& conflicts) const {
+    size_t classCount = 0;
+    for (const auto& courseClasses : classes) classCount += courseClasses.size();
+    conflicts.assign(classCount, std::vector<int>());
+    size_t bytes = classCount * sizeof(std::vector<int>);
+
+    // One student's courses, so plain pairwise checks do
+    for (size_t i = 0; i < classes.size(); ++i) {
+        for (size_t j = i + 1; j < classes.size(); ++j) {
+            for (size_t a = 0; a < classes[i].size(); ++a) {
+                for (size_t b = 0; b < classes[j].size(); ++b) {
+                    if (!classes[i][a].pattern->overlaps(*classes[j][b].pattern)) continue;
+                    bytes += 2 * sizeof(int);
+                    if (memoryLimitBytes > 0 && bytes > memoryLimitBytes) {
+                        conflicts.clear();
+                        return false;
+                    }
+                    conflicts[globalIds[i][a]].push_back(globalIds[j][b]);
+                    conflicts[globalIds[j][b]].push_back(globalIds[i][a]);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool PartialSolver::isIntervalStructured() const {
+    std::vector<unsigned> dayMasks;
+    for (const auto& courseClasses : classes) {
+        if (courseClasses.empty()) continue;
+        if (courseClasses.size() > 1) return false;
+
+        // One start and length on every day it meets
+        const auto& meetings = courseClasses[0].pattern->getMeetings();
+        for (PackedTimeSlot meeting : meetings) {
+            if (meeting.getStartMinute() != meetings[0].getStartMinute() ||
+                meeting.getDurationMinutes() != meetings[0].getDurationMinutes()) {
+                return false;
+            }
+        }
+        dayMasks.push_back(courseClasses[0].pattern->getDayMask());
+    }
+
+    // Partly shared days would make a clash depend on more than the times
+    std::sort(dayMasks.begin(), dayMasks.end());
+    dayMasks.erase(std::unique(dayMasks.begin(), dayMasks.end()), dayMasks.end());
+    for (size_t a = 0; a < dayMasks.size(); ++a) {
+        for (size_t b = a + 1; b < dayMasks.size(); ++b) {
+            if (dayMasks[a] & dayMasks[b]) return false;
+        }
+    }
+    return true;
+}
+
+void PartialSolver::solveIntervals(PartialResult& result) const {
+    // Groups on disjoint days never clash, so each is solved on its own
+    std::map<unsigned, std::vector<Interval>> groups;
+    for (size_t i = 0; i < classes.size(); ++i) {
+        if (classes[i].empty()) continue;
+        const SectionClass& sectionClass = classes[i][0];
+        PackedTimeSlot meeting = sectionClass.pattern->getMeetings()[0];
+        groups[sectionClass.pattern->getDayMask()].push_back(
+            Interval{static_cast<int>(i), meeting.getStartMinute(), meeting.getEndMinute(),
+                     Value{weights[i], sectionClass.score}});
+    }
+
+    for (auto& group : groups) {
+        std::vector<Interval>& intervals = group.second;
+        std::sort(intervals.begin(), intervals.end(),
+                  [](const Interval& a, const Interval& b) { return a.end < b.end; });
+
+        // best[j] covers the first j intervals; an interval combines with the
+        // best before the last one ending by its start
+        size_t count = intervals.size();
+        std::vector<Value> best(count + 1, Value{0.0f, 0.0f});
+        std::vector<size_t> previous(count);
+        for (size_t j = 0; j < count; ++j) {
+            previous[j] = std::upper_bound(intervals.begin(), intervals.begin() + j, intervals[j].start,
+                                           [](int start, const Interval& other) { return start < other.end; }) -
+                          intervals.begin();
+            Value take{best[previous[j]].weight + intervals[j].value.weight,
+                       best[previous[j]].score + intervals[j].value.score};
+            best[j + 1] = best[j] < take ? take : best[j];
+        }
+
+        for (size_t j = count; j > 0;) {
+            if (best[j - 1] < best[j]) {
+                result.choice[intervals[j - 1].course] = 0;
+                j = previous[j - 1];
+            } else {
+                --j;
+            }
+        }
+    }
+    result.optimal = true;
+}
+
+void PartialSolver::solveBranchAndBound(const PartialOptions& options, PartialResult& result) const {
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::vector<int>> conflicts;
+    if (!buildConflicts(options.memoryLimitBytes, conflicts)) {
+        solveGreedy(result);
+        result.budgetExhausted = true;
+        return;
+    }
+
+    // Heaviest courses first, each trying its best scoring classes first
+    std::vector<int> order;
+    for (size_t i = 0; i < classes.size(); ++i) {
+        if (!classes[i].empty()) order.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return weights[a] != weights[b] ? weights[a] > weights[b] : classes[a].size() < classes[b].size();
+    });
+    std::vector<std::vector<int>> tryOrder(classes.size());
+    for (int course : order) {
+        for (size_t k = 0; k < classes[course].size(); ++k) tryOrder[course].push_back(static_cast<int>(k));
+        std::stable_sort(tryOrder[course].begin(), tryOrder[course].end(), [this, course](int a, int b) {
+            return classes[course][a].score > classes[course][b].score;
+        });
+    }
+
+    size_t depthCount = order.size();
+    std::vector<Value> suffix(depthCount + 1, Value{0.0f, 0.0f});
+    // Dropping a course scores 0, so a course whose best class scores below that adds nothing
+    for (size_t d = depthCount; d-- > 0;) {
+        suffix[d].weight = suffix[d + 1].weight + weights[order[d]];
+        suffix[d].score = suffix[d + 1].score + std::max(0.0f, classes[order[d]][tryOrder[order[d]][0]].score);
+    }
+
+    std::vector<int> choice(classes.size(), -1);
+    std::vector<int> blocked(conflicts.size(), 0);
+    Value best{-1.0f, 0.0f};
+    bool stopped = false;
+
+    // Whether a subtree can still beat the incumbent
+    auto promising = [&best](float weight, float score, const Value& rest) {
+        Value bound{weight + rest.weight, score + rest.score};
+        return best < bound;
+    };
+
+    std::function<void(size_t, float, float)> searchFrom = [&](size_t depth, float weight, float score) {
+        if (depth == depthCount) {
+            best = Value{weight, score};
+            result.choice = choice;
+            return;
+        }
+
+        // The first dive reaches a leaf within one node per course, so the limits wait for it
+        result.nodes++;
+        bool limited = best.weight >= 0.0f &&
+            ((options.nodeLimit > 0 && result.nodes > options.nodeLimit) ||
+             (options.timeLimitSeconds > 0.0 && (result.nodes & 1023) == 0 &&
+              std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >
+                  options.timeLimitSeconds));
+        if (limited) {
+            stopped = true;
+            return;
+        }
+
+        int course = order[depth];
+        for (int k : tryOrder[course]) {
+            if (stopped) return;
+            int id = globalIds[course][k];
+            if (blocked[id] > 0) continue;
+
+            float nextWeight = weight + weights[course];
+            float nextScore = score + classes[course][k].score;
+            if (!promising(nextWeight, nextScore, suffix[depth + 1])) continue;
+
+            choice[course] = k;
+            for (int other : conflicts[id]) blocked[other]++;
+            searchFrom(depth + 1, nextWeight, nextScore);
+            for (int other : conflicts[id]) blocked[other]--;
+            choice[course] = -1;
+        }
+
+        // Dropping the course last, once everything that keeps it has been tried
+        if (!stopped && promising(weight, score, suffix[depth + 1])) {
+            searchFrom(depth + 1, weight, score);
+        }
+    };
+    searchFrom(0, 0.0f, 0.0f);
+
+    result.optimal = !stopped;
+    result.budgetExhausted = stopped;
+}
+
+void PartialSolver::solveGreedy(PartialResult& result) const {
+    // Heaviest courses first, each taking its best scoring class clear of those placed
+    std::vector<int> order;
+    for (size_t i = 0; i < classes.size(); ++i) {
+        if (!classes[i].empty()) order.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return weights[a] > weights[b]; });
+
+    std::vector<const MeetingPattern*> placed;
+    for (int course : order) {
+        int best = -1;
+        for (size_t k = 0; k < classes[course].size(); ++k) {
+            const MeetingPattern& pattern = *classes[course][k].pattern;
+            bool clear = true;
+            for (const MeetingPattern* other : placed) clear = clear && !pattern.overlaps(*other);
+            if (clear && (best < 0 || classes[course][best].score < classes[course][k].score)) {
+                best = static_cast<int>(k);
+            }
+        }
+        if (best < 0) continue;
+        result.choice[course] = best;
+        placed.push_back(classes[course][best].pattern.get());
+    }
+}
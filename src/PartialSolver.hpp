@@ -0,0 +1,57 @@
+#ifndef PARTIAL_SOLVER_HPP
+#define PARTIAL_SOLVER_HPP
+
+#include "ScheduleSolver.hpp"
+#include <vector>
+
+// Budgets for the branch and bound; zero means unlimited
+struct PartialOptions {
+    bool useCredits = true;          // weigh courses by credits, otherwise by priority
+    double timeLimitSeconds = 1.0;
+    size_t nodeLimit = 0;
+    size_t memoryLimitBytes = 0;     // cap on the clash lists between classes
+};
+
+struct PartialResult {
+    std::vector<int> choice;         // class index per course, -1 for a dropped course
+    float placedWeight = 0.0f;
+    float totalWeight = 0.0f;
+    float score = 0.0f;              // preference score of the placed classes
+    bool intervalStructured = false; // solved by weighted interval scheduling
+    bool optimal = false;            // no partial schedule places more weight
+    bool budgetExhausted = false;    // a time, node or memory limit stopped the search
+    size_t nodes = 0;
+    double seconds = 0.0;
+};
+
+// Best schedule that drops courses when not all of them fit: the placed
+// courses carry the largest total weight, ties going to the better
+// preference score. When every course has a single class and the patterns
+// meet on identical or disjoint days with one time each, clashes are plain
+// interval overlaps and weighted interval scheduling solves every group of
+// days exactly in O(n log n). Anything else goes to a branch and bound that
+// tries the heaviest courses first and bounds by the weight still available;
+// if its clash lists would outgrow the memory limit, courses are instead
+// placed greedily, heaviest first.
+class PartialSolver {
+public:
+    PartialSolver();
+
+    // weights[i] is what placing course i is worth
+    void build(const ScheduleSolver& solver, const std::vector<float>& weights);
+
+    PartialResult run(const PartialOptions& options = PartialOptions());
+
+private:
+    std::vector<std::vector<SectionClass>> classes;
+    std::vector<float> weights;
+    std::vector<std::vector<int>> globalIds;
+
+    bool isIntervalStructured() const;
+    bool buildConflicts(size_t memoryLimitBytes, std::vector<std::vector<int>>& conflicts) const;
+    void solveIntervals(PartialResult& result) const;
+    void solveBranchAndBound(const PartialOptions& options, PartialResult& result) const;
+    void solveGreedy(PartialResult& result) const;
+};
+
+#endif // PARTIAL_SOLVER_HPP
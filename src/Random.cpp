@@ -0,0 +1,39 @@
+#include "Random.hpp"
+
+Random::Random(uint64_t seed) : state(seed) {}
+
+void Random::seed(uint64_t seed) {
+    state = seed;
+}
+
+uint64_t Random::next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+size_t Random::nextIndex(size_t bound) {
+    // Rejection keeps the draw exactly uniform for any bound
+    uint64_t limit = max() - max() % bound;
+    uint64_t value;
+    do {
+        value = next();
+    } while (value >= limit);
+    return static_cast<size_t>(value % bound);
+}
+
+bool Random::nextBool() {
+    return (next() >> 63) != 0;
+}
+
+double Random::nextDouble() {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+Random Random::forStream(uint64_t seed, uint64_t stream) {
+    // Mix the stream number into the seed so neighbouring streams do not overlap
+    Random mixer(seed ^ (stream * 0xd1342543de82ef95ULL));
+    mixer.next();
+    return Random(mixer.next());
+}
@@ -0,0 +1,49 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+// Seedable random number stream (SplitMix64).
+// Every stochastic path in the scheduler takes one of these explicitly rather
+// than using rand() or std::random_device, so a run is reproducible from its
+// seed and no generator state is shared between threads. Index draws and
+// shuffles are implemented here instead of with std::uniform_int_distribution
+// and std::shuffle, whose output differs between standard libraries.
+class Random {
+public:
+    typedef uint64_t result_type;
+
+    explicit Random(uint64_t seed = 0x5eedULL);
+
+    void seed(uint64_t seed);
+    uint64_t next();
+
+    // Uniform integer in [0, bound), bound > 0
+    size_t nextIndex(size_t bound);
+    bool nextBool();
+    double nextDouble();
+
+    template <typename T>
+    void shuffle(std::vector<T>& items) {
+        for (size_t i = items.size(); i > 1; --i) {
+            std::swap(items[i - 1], items[nextIndex(i)]);
+        }
+    }
+
+    // Independent stream for worker `stream` of a run seeded with `seed`;
+    // the same (seed, stream) pair always gives the same sequence
+    static Random forStream(uint64_t seed, uint64_t stream);
+
+    // UniformRandomBitGenerator interface
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+    result_type operator()() { return next(); }
+
+private:
+    uint64_t state;
+};
+
+#endif // RANDOM_HPP
@@ -0,0 +1,273 @@
+#include "RegistrationSimulator.hpp"
+#include "Scheduler.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// LatencyHistogram implementation
+LatencyHistogram::LatencyHistogram() : counts(BUCKETS, 0), count(0), total(0.0), max(0.0) {}
+
+void LatencyHistogram::record(double seconds) {
+    double micros = seconds * 1e6;
+    size_t bucket = 0;
+    if (micros > 1.0) {
+        bucket = static_cast<size_t>(std::ceil(std::log2(micros) * BUCKETS_PER_DOUBLING));
+        bucket = std::min(bucket, BUCKETS - 1);
+    }
+    counts[bucket]++;
+    count++;
+    total += seconds;
+    max = std::max(max, seconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    total += other.total;
+    max = std::max(max, other.max);
+}
+
+size_t LatencyHistogram::getCount() const {
+    return count;
+}
+
+double LatencyHistogram::getMean() const {
+    return count > 0 ? total / count : 0.0;
+}
+
+double LatencyHistogram::getMax() const {
+    return max;
+}
+
+double LatencyHistogram::getPercentile(double fraction) const {
+    if (count == 0) return 0.0;
+    size_t target = static_cast<size_t>(std::ceil(fraction * count));
+    size_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= target && seen > 0) {
+            return std::min(getBucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+size_t LatencyHistogram::getBucketCount() const {
+    return BUCKETS;
+}
+
+double LatencyHistogram::getBucketUpperBound(size_t bucket) const {
+    return 1e-6 * std::exp2(static_cast<double>(bucket) / BUCKETS_PER_DOUBLING);
+}
+
+size_t LatencyHistogram::getBucketHits(size_t bucket) const {
+    return counts[bucket];
+}
+
+// RegistrationSimulator implementation
+RegistrationSimulator::RegistrationSimulator(const std::vector<std::shared_ptr<Course>>& catalog) {
+    // Only courses a student could actually get a seat in
+    for (const auto& course : catalog) {
+        if (!course->getSections().empty()) this->catalog.push_back(course);
+    }
+}
+
+RushResult RegistrationSimulator::run(const RushOptions& options) {
+    std::vector<Request> requests = generateRequests(options);
+
+    size_t threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, requests.size()));
+
+    // Students are independent apart from the seats, so workers take the next one in line
+    std::vector<WorkerStats> stats(threads);
+    std::atomic<size_t> next(0);
+    auto startTime = std::chrono::steady_clock::now();
+    auto work = [&](size_t worker) {
+        WorkerStats& own = stats[worker];
+        for (size_t i = next++; i < requests.size(); i = next++) {
+            auto arrival = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                           std::chrono::duration<double>(requests[i].arrival));
+            std::this_thread::sleep_until(arrival);
+
+            auto serviceStart = std::chrono::steady_clock::now();
+            registerStudent(requests[i], i, options, own);
+            auto finished = std::chrono::steady_clock::now();
+
+            own.result.latency.record(std::chrono::duration<double>(finished - arrival).count());
+            own.result.service.record(std::chrono::duration<double>(finished - serviceStart).count());
+            size_t second = static_cast<size_t>(std::chrono::duration<double>(finished - startTime).count());
+            if (own.result.completedPerSecond.size() <= second) own.result.completedPerSecond.resize(second + 1, 0);
+            own.result.completedPerSecond[second]++;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    RushResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    for (const auto& own : stats) {
+        result.requests += own.result.requests;
+        result.fullSchedules += own.result.fullSchedules;
+        result.partialSchedules += own.result.partialSchedules;
+        result.rejected += own.result.rejected;
+        result.seatsClaimed += own.result.seatsClaimed;
+        result.seatConflicts += own.result.seatConflicts;
+        result.resolves += own.result.resolves;
+        result.latency.merge(own.result.latency);
+        result.service.merge(own.result.service);
+        if (result.completedPerSecond.size() < own.result.completedPerSecond.size()) {
+            result.completedPerSecond.resize(own.result.completedPerSecond.size(), 0);
+        }
+        for (size_t s = 0; s < own.result.completedPerSecond.size(); ++s) {
+            result.completedPerSecond[s] += own.result.completedPerSecond[s];
+        }
+
+        if (!options.keepSeats) {
+            for (const auto& section : own.claimed) section->releaseSeat();
+        }
+    }
+    result.throughput = result.seconds > 0.0 ? result.requests / result.seconds : 0.0;
+    return result;
+}
+
+std::vector<RegistrationSimulator::Request> RegistrationSimulator::generateRequests(const RushOptions& options) const {
+    std::vector<Request> requests;
+    if (catalog.empty()) return requests;
+    Random random(options.seed);
+
+    // Popularity ranks are a shuffle of the catalog; rank r is drawn in proportion to 1 / (r + 1)^skew
+    std::vector<size_t> byPopularity(catalog.size());
+    for (size_t i = 0; i < byPopularity.size(); ++i) byPopularity[i] = i;
+    random.shuffle(byPopularity);
+    std::vector<double> cumulative(catalog.size());
+    double sum = 0.0;
+    for (size_t rank = 0; rank < catalog.size(); ++rank) {
+        sum += 1.0 / std::pow(static_cast<double>(rank + 1), options.popularitySkew);
+        cumulative[rank] = sum;
+    }
+
+    size_t minCourses = std::min(std::max<size_t>(1, options.minCourses), catalog.size());
+    size_t maxCourses = std::min(std::max(minCourses, options.maxCourses), catalog.size());
+    double arrival = 0.0;
+    for (size_t s = 0; s < options.students; ++s) {
+        Request request;
+        if (options.arrivalRate > 0.0) {
+            arrival += -std::log(1.0 - random.nextDouble()) / options.arrivalRate;
+        }
+        request.arrival = arrival;
+
+        size_t wanted = minCourses + random.nextIndex(maxCourses - minCourses + 1);
+        std::vector<bool> taken(catalog.size(), false);
+        while (request.courses.size() < wanted) {
+            size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), random.nextDouble() * sum) -
+                          cumulative.begin();
+            rank = std::min(rank, catalog.size() - 1);
+
+            // A repeat draw moves on to the next most popular course not yet taken
+            while (taken[rank]) rank = (rank + 1) % catalog.size();
+            taken[rank] = true;
+            request.courses.push_back(catalog[byPopularity[rank]]);
+        }
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+void RegistrationSimulator::registerStudent(const Request& request, size_t index, const RushOptions& options,
+                                            WorkerStats& stats) const {
+    RushResult& result = stats.result;
+    result.requests++;
+
+    Scheduler scheduler;
+    scheduler.setSeed(options.seed + index);
+    for (const auto& course : request.courses) {
+        scheduler.addCourse(course);
+    }
+    SolveOptions solve;
+    solve.timeLimitSeconds = options.solveTimeLimitSeconds;
+    solve.maxSchedules = std::max<size_t>(1, options.alternatives);
+
+    std::vector<std::shared_ptr<Section>> seats;
+    std::shared_ptr<Schedule> fallback;
+    for (size_t attempt = 0; attempt < std::max<size_t>(1, options.maxAttempts); ++attempt) {
+        if (attempt > 0) result.resolves++;
+
+        // Solving sees the seats as they are now, so full sections are already left out
+        std::vector<std::shared_ptr<Schedule>> candidates;
+        if (scheduler.generateSchedule(solve)) {
+            candidates = scheduler.getRankedSchedules(options.alternatives);
+        } else if (scheduler.getCurrentSchedule() && !scheduler.getCurrentSchedule()->getSections().empty()) {
+            candidates.push_back(scheduler.getCurrentSchedule());
+        }
+        if (candidates.empty()) break;  // every requested course is full
+        fallback = candidates[0];
+
+        for (const auto& candidate : candidates) {
+            if (claim(*candidate, seats)) break;
+            result.seatConflicts++;
+        }
+        if (!seats.empty()) break;
+    }
+
+    // Still outrun after every attempt: keep whichever seats of the last best schedule remain
+    if (seats.empty() && fallback) {
+        for (const auto& section : fallback->getSections()) {
+            Schedule single;
+            single.addSection(section);
+            claim(single, seats);
+        }
+    }
+
+    if (seats.empty()) {
+        result.rejected++;
+    } else if (seats.size() == request.courses.size()) {
+        result.fullSchedules++;
+    } else {
+        result.partialSchedules++;
+    }
+    result.seatsClaimed += seats.size();
+    stats.claimed.insert(stats.claimed.end(), seats.begin(), seats.end());
+}
+
+bool RegistrationSimulator::claim(const Schedule& schedule, std::vector<std::shared_ptr<Section>>& seats) {
+    std::vector<std::shared_ptr<Section>> claimed;
+    for (const auto& section : schedule.getSections()) {
+        bool seated = section->reserveSeat();
+        if (seated) {
+            claimed.push_back(section);
+            continue;
+        }
+
+        // Another section of the course meeting at the same times does just as well
+        auto pattern = section->getMeetingPattern();
+        for (const auto& other : section->getCourse()->getSections()) {
+            auto otherPattern = other->getMeetingPattern();
+            bool same = pattern && otherPattern ? *pattern == *otherPattern : pattern == otherPattern;
+            if (other != section && same && other->reserveSeat()) {
+                claimed.push_back(other);
+                seated = true;
+                break;
+            }
+        }
+        if (!seated) {
+            for (const auto& taken : claimed) taken->releaseSeat();
+            return false;
+        }
+    }
+    seats.insert(seats.end(), claimed.begin(), claimed.end());
+    return true;
+}
@@ -0,0 +1,102 @@
+#ifndef REGISTRATION_SIMULATOR_HPP
+#define REGISTRATION_SIMULATOR_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+// Latencies in log-spaced buckets, four per doubling from one microsecond,
+// so any percentile is within about 19% of the true value at every scale.
+// Workers each fill their own and merge them at the end.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(double seconds);
+    void merge(const LatencyHistogram& other);
+
+    size_t getCount() const;
+    double getMean() const;
+    double getMax() const;
+
+    // Upper edge of the bucket reaching the given fraction of requests, in seconds
+    double getPercentile(double fraction) const;
+
+    size_t getBucketCount() const;
+    double getBucketUpperBound(size_t bucket) const;
+    size_t getBucketHits(size_t bucket) const;
+
+private:
+    static const int BUCKETS_PER_DOUBLING = 4;
+    static const size_t BUCKETS = 4 * 36;  // up to about 19 hours
+
+    std::vector<size_t> counts;
+    size_t count;
+    double total;
+    double max;
+};
+
+struct RushOptions {
+    size_t students = 1000;
+    size_t minCourses = 3;
+    size_t maxCourses = 6;
+    double popularitySkew = 1.0;        // Zipf exponent of course popularity, 0 for uniform
+    double arrivalRate = 0.0;           // students arriving per second, zero for everyone at once
+    size_t threads = 0;                 // concurrent registrations, zero for one per hardware thread
+    size_t alternatives = 3;            // ranked schedules tried before solving again
+    size_t maxAttempts = 3;             // solves per student before taking whatever seats are left
+    double solveTimeLimitSeconds = 0.25;
+    bool keepSeats = false;             // leave the claimed seats enrolled after the run
+    uint64_t seed = 1;
+};
+
+struct RushResult {
+    size_t requests = 0;
+    size_t fullSchedules = 0;     // a seat in every requested course
+    size_t partialSchedules = 0;
+    size_t rejected = 0;          // not a single seat
+    size_t seatsClaimed = 0;
+    size_t seatConflicts = 0;     // schedules lost to other students between solving and claiming
+    size_t resolves = 0;          // solves beyond each student's first
+    double seconds = 0.0;
+    double throughput = 0.0;      // students finished per second
+    std::vector<size_t> completedPerSecond;
+    LatencyHistogram latency;     // arrival to seats claimed, including the wait for a worker
+    LatencyHistogram service;     // solving and claiming alone
+};
+
+// Load test for registration day. Generates students who each ask for a few
+// courses, drawn with Zipf-distributed popularity, and registers them on
+// worker threads at once or at a given arrival rate. Every registration is
+// a Scheduler of its own over the shared catalog: solving already skips
+// full sections, and the chosen seats are claimed atomically, so a student
+// who loses a seat between solving and claiming falls back to the next
+// ranked schedule, then solves again. Unless keepSeats is set, every seat
+// claimed is released again once the run is over.
+class RegistrationSimulator {
+public:
+    explicit RegistrationSimulator(const std::vector<std::shared_ptr<Course>>& catalog);
+
+    RushResult run(const RushOptions& options = RushOptions());
+
+private:
+    struct Request {
+        double arrival;  // seconds after the start
+        std::vector<std::shared_ptr<Course>> courses;
+    };
+
+    // What one worker saw, merged into the result at the end
+    struct WorkerStats {
+        RushResult result;
+        std::vector<std::shared_ptr<Section>> claimed;
+    };
+
+    std::vector<std::shared_ptr<Course>> catalog;
+
+    std::vector<Request> generateRequests(const RushOptions& options) const;
+    void registerStudent(const Request& request, size_t index, const RushOptions& options, WorkerStats& stats) const;
+    static bool claim(const Schedule& schedule, std::vector<std::shared_ptr<Section>>& seats);
+};
+
+#endif // REGISTRATION_SIMULATOR_HPP
@@ -0,0 +1,179 @@
+#include "RequirementMask.hpp"
+#include "SchedulePool.hpp"
+#include <algorithm>
+
+// SectionMask implementation
+SectionMask::SectionMask() : bits(0) {}
+
+SectionMask::SectionMask(size_t size, bool value)
+    : words((size + 63) / 64, value ? ~uint64_t(0) : 0), bits(size) {
+    // Keep the unused high bits of the last word clear so any()/count() stay exact
+    if (value && size % 64 != 0) {
+        words.back() &= (uint64_t(1) << (size % 64)) - 1;
+    }
+}
+
+size_t SectionMask::size() const {
+    return bits;
+}
+
+bool SectionMask::test(size_t index) const {
+    return index < bits && (words[index / 64] >> (index % 64)) & 1;
+}
+
+void SectionMask::set(size_t index) {
+    if (index < bits) {
+        words[index / 64] |= uint64_t(1) << (index % 64);
+    }
+}
+
+void SectionMask::reset(size_t index) {
+    if (index < bits) {
+        words[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+}
+
+bool SectionMask::any() const {
+    for (uint64_t word : words) {
+        if (word) return true;
+    }
+    return false;
+}
+
+size_t SectionMask::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+bool SectionMask::intersects(const SectionMask& other) const {
+    size_t n = std::min(words.size(), other.words.size());
+    for (size_t i = 0; i < n; ++i) {
+        if (words[i] & other.words[i]) return true;
+    }
+    return false;
+}
+
+SectionMask& SectionMask::operator&=(const SectionMask& other) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] &= (i < other.words.size()) ? other.words[i] : 0;
+    }
+    return *this;
+}
+
+// CompiledRequirements implementation
+CompiledRequirements::CompiledRequirements() : constrainedCount(0), unsatisfiable(false) {}
+
+void CompiledRequirements::compile(const std::vector<std::shared_ptr<Course>>& courses,
+                                   const std::vector<std::shared_ptr<Requirement>>& requirements) {
+    allowed.clear();
+    constrained.assign(courses.size(), false);
+    courseIndices.clear();
+    sectionIndices.clear();
+    unsatisfiable = false;
+
+    // Number every course and section once so the solver can work with plain indices
+    for (size_t i = 0; i < courses.size(); ++i) {
+        const auto& sections = courses[i]->getSections();
+        courseIndices[courses[i].get()] = static_cast<int>(i);
+        allowed.emplace_back(sections.size(), true);
+
+        for (size_t j = 0; j < sections.size(); ++j) {
+            sectionIndices[sections[j].get()] = static_cast<int>(j);
+
+            // A full section is as unavailable as one a requirement rejects, and so is
+            // one past what the schedule pool can store
+            if (!sections[j]->hasSeatsLeft() || j >= SchedulePool::NO_SECTION) {
+                allowed.back().reset(j);
+                constrained[i] = true;
+            }
+        }
+    }
+
+    // Lower each requirement into the set of sections it accepts and intersect per course
+    for (const auto& requirement : requirements) {
+        auto course = requirement->getCourse();
+        auto it = courseIndices.find(course.get());
+        if (it == courseIndices.end()) {
+            unsatisfiable = true;
+            continue;
+        }
+
+        const auto& sections = course->getSections();
+        SectionMask accepted(sections.size());
+        for (size_t j = 0; j < sections.size(); ++j) {
+            if (requirement->allowsSection(*sections[j])) {
+                accepted.set(j);
+            }
+        }
+
+        allowed[it->second] &= accepted;
+        constrained[it->second] = true;
+    }
+    constrainedCount = std::count(constrained.begin(), constrained.end(), true);
+}
+
+size_t CompiledRequirements::getCourseCount() const {
+    return allowed.size();
+}
+
+const SectionMask& CompiledRequirements::getAllowedSections(size_t courseIndex) const {
+    return allowed[courseIndex];
+}
+
+bool CompiledRequirements::isConstrained(size_t courseIndex) const {
+    return constrained[courseIndex];
+}
+
+bool CompiledRequirements::isUnsatisfiable() const {
+    return unsatisfiable;
+}
+
+int CompiledRequirements::getCourseIndex(const Course* course) const {
+    auto it = courseIndices.find(course);
+    return it == courseIndices.end() ? -1 : it->second;
+}
+
+int CompiledRequirements::getSectionIndex(const Section* section) const {
+    auto it = sectionIndices.find(section);
+    return it == sectionIndices.end() ? -1 : it->second;
+}
+
+bool CompiledRequirements::isSatisfied(const std::vector<int>& choice) const {
+    if (unsatisfiable) return false;
+
+    for (size_t i = 0; i < allowed.size(); ++i) {
+        if (!constrained[i]) continue;
+        if (i >= choice.size() || choice[i] < 0 || !allowed[i].test(choice[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledRequirements::isSatisfied(const Schedule& schedule) const {
+    if (unsatisfiable) return false;
+
+    // Count the constrained courses with an allowed section chosen, each course once
+    const auto& sections = schedule.getSections();
+    size_t satisfied = 0;
+    for (size_t k = 0; k < sections.size(); ++k) {
+        const Course* course = sections[k]->getCourse().get();
+        int courseIndex = getCourseIndex(course);
+        if (courseIndex < 0 || !constrained[courseIndex] || !isAllowed(courseIndex, *sections[k])) continue;
+
+        bool counted = false;
+        for (size_t earlier = 0; earlier < k && !counted; ++earlier) {
+            counted = sections[earlier]->getCourse().get() == course && isAllowed(courseIndex, *sections[earlier]);
+        }
+        if (!counted) satisfied++;
+    }
+    return satisfied == constrainedCount;
+}
+
+bool CompiledRequirements::isAllowed(int courseIndex, const Section& section) const {
+    int sectionIndex = getSectionIndex(&section);
+    return sectionIndex >= 0 && allowed[courseIndex].test(sectionIndex);
+}
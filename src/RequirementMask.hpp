@@ -0,0 +1,71 @@
+#ifndef REQUIREMENT_MASK_HPP
+#define REQUIREMENT_MASK_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Bitset over the section indices of a single course
+class SectionMask {
+public:
+    SectionMask();
+    explicit SectionMask(size_t size, bool value = false);
+
+    size_t size() const;
+    bool test(size_t index) const;
+    void set(size_t index);
+    void reset(size_t index);
+
+    bool any() const;
+    size_t count() const;
+    bool intersects(const SectionMask& other) const;
+
+    SectionMask& operator&=(const SectionMask& other);
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits;
+};
+
+// Requirements lowered into one allowed-section mask per course.
+// Course i is the i-th course passed to compile(), and section j of a course
+// is the j-th entry of Course::getSections().
+class CompiledRequirements {
+public:
+    CompiledRequirements();
+
+    void compile(const std::vector<std::shared_ptr<Course>>& courses,
+                 const std::vector<std::shared_ptr<Requirement>>& requirements);
+
+    size_t getCourseCount() const;
+    const SectionMask& getAllowedSections(size_t courseIndex) const;
+    bool isConstrained(size_t courseIndex) const;
+
+    // True when some requirement names a course that is not being scheduled
+    bool isUnsatisfiable() const;
+
+    // Index lookups, -1 if the course or section was not compiled
+    int getCourseIndex(const Course* course) const;
+    int getSectionIndex(const Section* section) const;
+
+    // choice[i] is the section index picked for course i, or -1 for none
+    bool isSatisfied(const std::vector<int>& choice) const;
+    bool isSatisfied(const Schedule& schedule) const;
+
+private:
+    std::vector<SectionMask> allowed;
+    std::vector<bool> constrained;
+    size_t constrainedCount;
+    std::unordered_map<const Course*, int> courseIndices;
+    std::unordered_map<const Section*, int> sectionIndices;
+
+    // Set when a requirement refers to a course that is not being scheduled
+    bool unsatisfiable;
+
+    // Helper method to test a section against its course's mask
+    bool isAllowed(int courseIndex, const Section& section) const;
+};
+
+#endif // REQUIREMENT_MASK_HPP
@@ -0,0 +1,224 @@
+#include "RoomAssigner.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+RoomAssigner::RoomAssigner() {}
+
+void RoomAssigner::addRoom(std::shared_ptr<Room> room) {
+    rooms.push_back(room);
+}
+
+void RoomAssigner::addSection(std::shared_ptr<Section> section) {
+    sections.push_back(section);
+}
+
+RoomAssignmentResult RoomAssigner::run() {
+    RoomAssignmentResult result;
+    unassigned.clear();
+
+    // Rooms ordered smallest first, so the first fitting free room is the best fit
+    std::vector<std::shared_ptr<Room>> ordered = rooms;
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const std::shared_ptr<Room>& a, const std::shared_ptr<Room>& b) {
+                         if (a->getCapacity() != b->getCapacity()) return a->getCapacity() < b->getCapacity();
+                         return a->getFeatures().size() < b->getFeatures().size();
+                     });
+
+    // Rooms with exactly the same features form a group, and a section can use
+    // every group holding all the features it needs. Feature ids have no limit.
+    std::unordered_map<std::string, int> featureIds;
+    auto featureSet = [&featureIds](const std::vector<std::string>& features, bool addMissing,
+                                    std::vector<int>& ids) {
+        ids.clear();
+        for (const auto& feature : features) {
+            auto it = featureIds.find(feature);
+            if (it == featureIds.end()) {
+                if (!addMissing) return false;
+                it = featureIds.emplace(feature, static_cast<int>(featureIds.size())).first;
+            }
+            ids.push_back(it->second);
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return true;
+    };
+
+    std::map<std::vector<int>, int> groupByFeatures;
+    std::vector<std::vector<size_t>> groupRooms;  // room ranks, smallest first
+    std::vector<int> groupOf(ordered.size());
+    std::vector<int> capacities(ordered.size(), 0);
+    std::vector<int> ids;
+    for (size_t r = 0; r < ordered.size(); ++r) {
+        capacities[r] = ordered[r]->getCapacity();
+        featureSet(ordered[r]->getFeatures(), true, ids);
+        auto inserted = groupByFeatures.emplace(ids, static_cast<int>(groupRooms.size()));
+        if (inserted.second) groupRooms.push_back(std::vector<size_t>());
+        groupOf[r] = inserted.first->second;
+        groupRooms[groupOf[r]].push_back(r);
+    }
+
+    // Groups usable per distinct set of needed features, worked out once per set
+    std::map<std::vector<int>, std::vector<int>> groupsFor;
+    auto usableGroups = [&](const std::vector<int>& needed) -> const std::vector<int>* {
+        auto it = groupsFor.find(needed);
+        if (it != groupsFor.end()) return &it->second;
+
+        std::vector<int>& usable = groupsFor[needed];
+        for (const auto& group : groupByFeatures) {
+            if (std::includes(group.first.begin(), group.first.end(), needed.begin(), needed.end())) {
+                usable.push_back(group.second);
+            }
+        }
+        return &usable;
+    };
+
+    struct Interval {
+        int day;
+        int start;
+        int end;
+        const std::vector<int>* groups;
+        size_t section;
+    };
+
+    std::vector<Interval> intervals;
+    std::vector<std::pair<const std::vector<int>*, size_t>> recurring;  // (groups, section) meeting more than once a week
+    for (size_t i = 0; i < sections.size(); ++i) {
+        auto pattern = sections[i]->getMeetingPattern();
+        if (!pattern) continue;
+
+        // A feature no room has can never be provided
+        const std::vector<int>* groups = nullptr;
+        if (featureSet(sections[i]->getRequiredFeatures(), false, ids)) groups = usableGroups(ids);
+        if (!groups || groups->empty()) {
+            sections[i]->setRoom(nullptr);
+            unassigned.push_back(sections[i]);
+            continue;
+        }
+
+        if (pattern->getMeetings().size() > 1) {
+            recurring.push_back(std::make_pair(groups, i));
+            continue;
+        }
+        PackedTimeSlot meeting = pattern->getMeetings().front();
+        intervals.push_back(Interval{meeting.getDay(), meeting.getStartMinute(), meeting.getEndMinute(), groups, i});
+    }
+
+    std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+        if (a.day != b.day) return a.day < b.day;
+        if (a.start != b.start) return a.start < b.start;
+        if (a.end != b.end) return a.end > b.end;
+        return a.section < b.section;
+    });
+
+    typedef std::pair<int, size_t> BusyRoom; // (end minute, room rank)
+    std::vector<bool> used(ordered.size(), false);
+
+    // A room has to be free at every meeting of a recurring section, which the
+    // day sweeps cannot see, so those take the smallest fitting room first and
+    // reserve it for their meetings. Reservations of a room never overlap, so
+    // keyed by start minute of the week they are ordered by end as well.
+    std::vector<std::map<int, int>> reserved(ordered.size());
+    auto isReserved = [&reserved](size_t room, PackedTimeSlot meeting) {
+        int start = meeting.getDay() * 1440 + meeting.getStartMinute();
+        int end = meeting.getDay() * 1440 + meeting.getEndMinute();
+        auto it = reserved[room].lower_bound(end);
+        return it != reserved[room].begin() && (--it)->second > start;
+    };
+    for (const auto& entry : recurring) {
+        const auto& section = sections[entry.second];
+        const auto& meetings = section->getMeetingPattern()->getMeetings();
+        size_t firstFitting = std::lower_bound(capacities.begin(), capacities.end(), section->getExpectedSize()) -
+                              capacities.begin();
+
+        // Smallest room over the usable groups that is free at every meeting
+        size_t room = ordered.size();
+        for (int group : *entry.first) {
+            const std::vector<size_t>& members = groupRooms[group];
+            for (auto it = std::lower_bound(members.begin(), members.end(), firstFitting);
+                 it != members.end() && *it < room; ++it) {
+                bool free = true;
+                for (PackedTimeSlot meeting : meetings) {
+                    free = free && !isReserved(*it, meeting);
+                }
+                if (free) {
+                    room = *it;
+                    break;
+                }
+            }
+        }
+
+        if (room == ordered.size()) {
+            section->setRoom(nullptr);
+            unassigned.push_back(section);
+            continue;
+        }
+        for (PackedTimeSlot meeting : meetings) {
+            reserved[room].emplace(meeting.getDay() * 1440 + meeting.getStartMinute(),
+                                   meeting.getDay() * 1440 + meeting.getEndMinute());
+        }
+        used[room] = true;
+        section->setRoom(ordered[room]);
+        result.assigned++;
+    }
+
+    size_t next = 0;
+    while (next < intervals.size()) {
+        int day = intervals[next].day;
+
+        // Fresh sweep for every day: all rooms free, nothing busy. The ranks are
+        // sorted already, so filling each group's set takes linear time.
+        std::vector<std::set<size_t>> freeRooms;
+        for (const auto& members : groupRooms) {
+            freeRooms.emplace_back(members.begin(), members.end());
+        }
+        std::priority_queue<BusyRoom, std::vector<BusyRoom>, std::greater<BusyRoom>> busy;
+
+        for (; next < intervals.size() && intervals[next].day == day; ++next) {
+            const Interval& interval = intervals[next];
+
+            // Rooms whose class ended by now are free again
+            while (!busy.empty() && busy.top().first <= interval.start) {
+                freeRooms[groupOf[busy.top().second]].insert(busy.top().second);
+                busy.pop();
+            }
+
+            // Smallest free room with enough seats in any usable group, skipping reserved ones
+            size_t firstFitting = std::lower_bound(capacities.begin(), capacities.end(),
+                                                   sections[interval.section]->getExpectedSize()) - capacities.begin();
+            PackedTimeSlot meeting(interval.day, interval.start, interval.end - interval.start);
+            size_t room = ordered.size();
+            for (int group : *interval.groups) {
+                auto it = freeRooms[group].lower_bound(firstFitting);
+                while (it != freeRooms[group].end() && *it < room && isReserved(*it, meeting)) {
+                    ++it;
+                }
+                if (it != freeRooms[group].end() && *it < room) room = *it;
+            }
+
+            if (room == ordered.size()) {
+                sections[interval.section]->setRoom(nullptr);
+                unassigned.push_back(sections[interval.section]);
+                continue;
+            }
+
+            freeRooms[groupOf[room]].erase(room);
+            busy.push(BusyRoom(interval.end, room));
+            used[room] = true;
+
+            sections[interval.section]->setRoom(ordered[room]);
+            result.assigned++;
+        }
+    }
+
+    result.unassigned = unassigned.size();
+    result.roomsUsed = static_cast<size_t>(std::count(used.begin(), used.end(), true));
+    return result;
+}
+
+const std::vector<std::shared_ptr<Section>>& RoomAssigner::getUnassigned() const {
+    return unassigned;
+}
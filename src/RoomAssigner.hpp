@@ -0,0 +1,45 @@
+#ifndef ROOM_ASSIGNER_HPP
+#define ROOM_ASSIGNER_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+
+struct RoomAssignmentResult {
+    size_t assigned = 0;
+    size_t unassigned = 0;  // no free room with enough seats and the required features
+    size_t roomsUsed = 0;
+};
+
+// Puts every timed section into a room once the times are fixed.
+// Each day is an interval-graph coloring: sections are swept by start time,
+// rooms that have become free are returned from a min-heap keyed on end time,
+// and the section takes the smallest free room that has enough seats and all
+// required features. With interchangeable rooms this uses the minimum number
+// of rooms.
+// Rooms with the same features share a group that keeps its free rooms in
+// size order, so a section costs one O(log n) lookup per group it could use
+// and the sweep is O(n log n) when rooms differ in few feature sets. Rooms a
+// recurring section holds at that time are stepped over one by one.
+// Sections meeting several times a week go first, each into the smallest
+// fitting room free at all its meetings, found by scanning the usable rooms
+// from the smallest that is large enough, and the sweeps skip what they reserve.
+class RoomAssigner {
+public:
+    RoomAssigner();
+
+    void addRoom(std::shared_ptr<Room> room);
+    void addSection(std::shared_ptr<Section> section);
+
+    // Assigns rooms and writes them to the sections
+    RoomAssignmentResult run();
+
+    const std::vector<std::shared_ptr<Section>>& getUnassigned() const;
+
+private:
+    std::vector<std::shared_ptr<Room>> rooms;
+    std::vector<std::shared_ptr<Section>> sections;
+    std::vector<std::shared_ptr<Section>> unassigned;
+};
+
+#endif // ROOM_ASSIGNER_HPP
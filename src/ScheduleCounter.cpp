@@ -0,0 +1,258 @@
+#include "ScheduleCounter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+namespace {
+
+bool intersects(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+    for (size_t w = 0; w < a.size(); ++w) {
+        if (a[w] & b[w]) return true;
+    }
+    return false;
+}
+
+}
+
+size_t ScheduleCounter::OccupancyHash::operator()(const Occupancy& occupancy) const {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    for (uint64_t word : occupancy) {
+        hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return static_cast<size_t>(hash);
+}
+
+ScheduleCounter::ScheduleCounter()
+    : stateCount(0), stateLimit(0), timeLimit(0.0), overflow(false), counted(false), infeasible(false) {}
+
+void ScheduleCounter::build(const ScheduleSolver& solver) {
+    infeasible = solver.isInfeasible();
+    counted = false;
+    memo.clear();
+
+    classes.clear();
+    for (size_t i = 0; i < solver.getCourseCount(); ++i) {
+        classes.push_back(solver.getClasses(i));
+    }
+
+    // Every meeting start and end splits its day into atoms
+    std::map<int, std::vector<int>> boundaries;
+    for (const auto& courseClasses : classes) {
+        for (const auto& sectionClass : courseClasses) {
+            for (PackedTimeSlot meeting : sectionClass.pattern->getMeetings()) {
+                boundaries[meeting.getDay()].push_back(meeting.getStartMinute());
+                boundaries[meeting.getDay()].push_back(meeting.getEndMinute());
+            }
+        }
+    }
+
+    std::map<int, size_t> firstAtom;
+    size_t atomCount = 0;
+    for (auto& day : boundaries) {
+        std::sort(day.second.begin(), day.second.end());
+        day.second.erase(std::unique(day.second.begin(), day.second.end()), day.second.end());
+        firstAtom[day.first] = atomCount;
+        atomCount += day.second.size() - 1;
+    }
+    size_t words = std::max<size_t>(1, (atomCount + 63) / 64);
+
+    classAtoms.assign(classes.size(), std::vector<Occupancy>());
+    order.clear();
+    for (size_t i = 0; i < classes.size(); ++i) {
+        for (const auto& sectionClass : classes[i]) {
+            Occupancy atoms(words, 0);
+            for (PackedTimeSlot meeting : sectionClass.pattern->getMeetings()) {
+                const std::vector<int>& cuts = boundaries[meeting.getDay()];
+                size_t from = std::lower_bound(cuts.begin(), cuts.end(), meeting.getStartMinute()) - cuts.begin();
+                size_t to = std::lower_bound(cuts.begin(), cuts.end(), meeting.getEndMinute()) - cuts.begin();
+                for (size_t a = firstAtom[meeting.getDay()] + from; a < firstAtom[meeting.getDay()] + to; ++a) {
+                    atoms[a / 64] |= uint64_t(1) << (a % 64);
+                }
+            }
+            classAtoms[i].push_back(atoms);
+        }
+        if (!classes[i].empty()) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+
+    futureAtoms.assign(order.size() + 1, Occupancy(words, 0));
+    for (size_t d = order.size(); d-- > 0;) {
+        futureAtoms[d] = futureAtoms[d + 1];
+        for (const auto& atoms : classAtoms[order[d]]) {
+            for (size_t w = 0; w < words; ++w) futureAtoms[d][w] |= atoms[w];
+        }
+    }
+}
+
+ScheduleCount ScheduleCounter::count(size_t maxStates, Random& random, double timeLimitSeconds) {
+    ScheduleCount result;
+    startTime = std::chrono::steady_clock::now();
+    timeLimit = timeLimitSeconds;
+
+    memo.assign(order.size(), std::unordered_map<Occupancy, double, OccupancyHash>());
+    stateCount = 0;
+    stateLimit = maxStates;
+    overflow = false;
+    counted = true;
+
+    if (infeasible) {
+        return result;
+    }
+
+    double total = countFrom(0, Occupancy(futureAtoms.back().size(), 0));
+    if (overflow) {
+        // Too many distinct states to count exactly in time; estimate from random probes instead
+        memo.clear();
+        total = estimate(random, 4096);
+    }
+
+    result.count = total;
+    result.exact = !overflow && total <= 9007199254740992.0; // 2^53, the largest exact double integer
+    result.states = stateCount;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+bool ScheduleCounter::sample(Random& random, std::vector<int>& choice) {
+    choice.assign(classes.size(), -1);
+    if (infeasible || !counted) return false;
+    if (overflow) return sampleByRejection(random, choice);
+
+    Occupancy occupied(futureAtoms.back().size(), 0);
+    if (countFrom(0, occupied) <= 0.0) return false;
+
+    // Take each class with probability proportional to the schedules beneath it
+    Occupancy next;
+    for (size_t depth = 0; depth < order.size(); ++depth) {
+        int course = order[depth];
+        std::vector<double> weights(classes[course].size(), 0.0);
+        double total = 0.0;
+        for (size_t k = 0; k < classes[course].size(); ++k) {
+            if (intersects(occupied, classAtoms[course][k])) continue;
+            next = occupied;
+            for (size_t w = 0; w < next.size(); ++w) next[w] |= classAtoms[course][k][w];
+            weights[k] = classes[course][k].members.size() * countFrom(depth + 1, next);
+            total += weights[k];
+        }
+
+        double target = random.nextDouble() * total;
+        size_t pick = 0;
+        for (size_t k = 0; k < weights.size(); ++k) {
+            if (weights[k] <= 0.0) continue;
+            pick = k;
+            if (target < weights[k]) break;
+            target -= weights[k];
+        }
+
+        const auto& members = classes[course][pick].members;
+        choice[course] = members[random.nextIndex(members.size())];
+        for (size_t w = 0; w < occupied.size(); ++w) occupied[w] |= classAtoms[course][pick][w];
+    }
+    return true;
+}
+
+double ScheduleCounter::countFrom(size_t depth, const Occupancy& occupied) {
+    if (depth == order.size()) return 1.0;
+
+    // Only atoms that this or a later course can use tell two states apart
+    Occupancy key(occupied.size());
+    for (size_t w = 0; w < key.size(); ++w) key[w] = occupied[w] & futureAtoms[depth][w];
+
+    auto it = memo[depth].find(key);
+    if (it != memo[depth].end()) return it->second;
+    bool outOfTime = timeLimit > 0.0 && (stateCount & 1023) == 1023 &&
+                     std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() > timeLimit;
+    if (stateCount >= stateLimit || outOfTime) {
+        overflow = true;
+        return 0.0;
+    }
+
+    int course = order[depth];
+    double total = 0.0;
+    Occupancy next(key.size());
+    for (size_t k = 0; k < classes[course].size(); ++k) {
+        const Occupancy& atoms = classAtoms[course][k];
+        if (intersects(key, atoms)) continue;
+
+        for (size_t w = 0; w < key.size(); ++w) next[w] = key[w] | atoms[w];
+        total += classes[course][k].members.size() * countFrom(depth + 1, next);
+        if (overflow) return 0.0;
+    }
+
+    memo[depth].emplace(key, total);
+    stateCount++;
+    return total;
+}
+
+double ScheduleCounter::estimate(Random& random, size_t probes) const {
+    // Knuth's estimator: walk one random path, multiplying the number of choices seen at each step
+    double sum = 0.0;
+    std::vector<double> weights;
+    for (size_t p = 0; p < probes; ++p) {
+        Occupancy occupied(futureAtoms.back().size(), 0);
+        double product = 1.0;
+
+        for (size_t depth = 0; depth < order.size() && product > 0.0; ++depth) {
+            int course = order[depth];
+            weights.assign(classes[course].size(), 0.0);
+            double total = 0.0;
+            for (size_t k = 0; k < classes[course].size(); ++k) {
+                if (intersects(occupied, classAtoms[course][k])) continue;
+                weights[k] = static_cast<double>(classes[course][k].members.size());
+                total += weights[k];
+            }
+            if (total <= 0.0) {
+                product = 0.0;
+                break;
+            }
+
+            double target = random.nextDouble() * total;
+            size_t pick = 0;
+            for (size_t k = 0; k < weights.size(); ++k) {
+                if (weights[k] <= 0.0) continue;
+                pick = k;
+                if (target < weights[k]) break;
+                target -= weights[k];
+            }
+
+            product *= total;
+            for (size_t w = 0; w < occupied.size(); ++w) occupied[w] |= classAtoms[course][pick][w];
+        }
+        sum += product;
+    }
+    return sum / static_cast<double>(probes);
+}
+
+bool ScheduleCounter::sampleByRejection(Random& random, std::vector<int>& choice) const {
+    // Uniform over every allowed section, restarting on the first clash
+    const size_t maxAttempts = 100000;
+    for (size_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        Occupancy occupied(futureAtoms.back().size(), 0);
+        bool clash = false;
+
+        for (size_t depth = 0; depth < order.size() && !clash; ++depth) {
+            int course = order[depth];
+            size_t sectionCount = 0;
+            for (const auto& sectionClass : classes[course]) sectionCount += sectionClass.members.size();
+
+            size_t pick = random.nextIndex(sectionCount);
+            size_t k = 0;
+            while (pick >= classes[course][k].members.size()) {
+                pick -= classes[course][k].members.size();
+                ++k;
+            }
+
+            if (intersects(occupied, classAtoms[course][k])) {
+                clash = true;
+                break;
+            }
+            choice[course] = classes[course][k].members[pick];
+            for (size_t w = 0; w < occupied.size(); ++w) occupied[w] |= classAtoms[course][k][w];
+        }
+
+        if (!clash) return true;
+        std::fill(choice.begin(), choice.end(), -1);
+    }
+    return false;
+}
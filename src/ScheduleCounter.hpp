@@ -0,0 +1,67 @@
+#ifndef SCHEDULE_COUNTER_HPP
+#define SCHEDULE_COUNTER_HPP
+
+#include "ScheduleSolver.hpp"
+#include "Random.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+struct ScheduleCount {
+    double count = 0.0;
+    bool exact = true;   // false when the state table or the time ran out and the count was estimated
+    size_t states = 0;   // memoized (course, occupancy) states
+    double seconds = 0.0;
+};
+
+// Counts and samples the valid concrete schedules behind a built solver.
+// Every class occupies a set of time atoms (the pieces a day splits into at
+// every meeting boundary), so two classes clash exactly when their atom masks
+// intersect. The count is a DP over courses whose state is the occupancy mask
+// restricted to atoms later courses can still use; equal states are solved
+// once. When the number of states passes the limit, or counting runs out of
+// time, the count falls back to Knuth's random-probe estimator. With a complete table, sample() draws
+// uniformly by walking down the DP with probabilities proportional to the
+// counts below each choice; otherwise it uses rejection sampling.
+class ScheduleCounter {
+public:
+    ScheduleCounter();
+
+    void build(const ScheduleSolver& solver);
+
+    // A time limit of zero means unlimited
+    ScheduleCount count(size_t maxStates, Random& random, double timeLimitSeconds = 0.0);
+
+    // One uniformly random valid schedule as per-course section indices; false if none was found
+    bool sample(Random& random, std::vector<int>& choice);
+
+private:
+    typedef std::vector<uint64_t> Occupancy;
+
+    struct OccupancyHash {
+        size_t operator()(const Occupancy& occupancy) const;
+    };
+
+    std::vector<std::vector<SectionClass>> classes;
+    std::vector<std::vector<Occupancy>> classAtoms;
+
+    // Courses that have something to pick, and the atoms still in use from each depth on
+    std::vector<int> order;
+    std::vector<Occupancy> futureAtoms;
+
+    std::vector<std::unordered_map<Occupancy, double, OccupancyHash>> memo;
+    size_t stateCount;
+    size_t stateLimit;
+    std::chrono::steady_clock::time_point startTime;
+    double timeLimit;
+    bool overflow;
+    bool counted;
+    bool infeasible;
+
+    double countFrom(size_t depth, const Occupancy& occupied);
+    double estimate(Random& random, size_t probes) const;
+    bool sampleByRejection(Random& random, std::vector<int>& choice) const;
+};
+
+#endif // SCHEDULE_COUNTER_HPP
@@ -0,0 +1,94 @@
+#include "SchedulePool.hpp"
+
+const uint16_t SchedulePool::NO_SECTION;
+
+SchedulePool::SchedulePool() : courseCount(0) {}
+
+void SchedulePool::reset(size_t courseCount) {
+    this->courseCount = courseCount;
+    sections.clear();
+    fingerprints.clear();
+    scores.clear();
+}
+
+void SchedulePool::reserve(size_t schedules) {
+    sections.reserve(schedules * courseCount);
+    fingerprints.reserve(schedules);
+    scores.reserve(schedules);
+}
+
+SchedulePool::Handle SchedulePool::add(const std::vector<int>& choice, float score) {
+    Handle handle = static_cast<Handle>(scores.size());
+    sections.resize(sections.size() + courseCount, NO_SECTION);
+    fingerprints.push_back(0);
+    scores.push_back(0.0f);
+    write(handle, choice, score);
+    return handle;
+}
+
+void SchedulePool::assign(Handle handle, const std::vector<int>& choice, float score) {
+    write(handle, choice, score);
+}
+
+size_t SchedulePool::size() const {
+    return scores.size();
+}
+
+bool SchedulePool::empty() const {
+    return scores.empty();
+}
+
+size_t SchedulePool::getCourseCount() const {
+    return courseCount;
+}
+
+int SchedulePool::getSection(Handle handle, size_t courseIndex) const {
+    uint16_t section = sections[static_cast<size_t>(handle) * courseCount + courseIndex];
+    return section == NO_SECTION ? -1 : static_cast<int>(section);
+}
+
+std::vector<int> SchedulePool::getChoice(Handle handle) const {
+    std::vector<int> choice(courseCount, -1);
+    for (size_t i = 0; i < courseCount; ++i) {
+        choice[i] = getSection(handle, i);
+    }
+    return choice;
+}
+
+uint64_t SchedulePool::getFingerprint(Handle handle) const {
+    return fingerprints[handle];
+}
+
+float SchedulePool::getScore(Handle handle) const {
+    return scores[handle];
+}
+
+bool SchedulePool::equals(Handle a, Handle b) const {
+    if (fingerprints[a] != fingerprints[b]) return false;
+    for (size_t i = 0; i < courseCount; ++i) {
+        if (sections[static_cast<size_t>(a) * courseCount + i] != sections[static_cast<size_t>(b) * courseCount + i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SchedulePool::getBytesPerSchedule() const {
+    return courseCount * sizeof(uint16_t) + sizeof(uint64_t) + sizeof(float);
+}
+
+void SchedulePool::write(Handle handle, const std::vector<int>& choice, float score) {
+    size_t row = static_cast<size_t>(handle) * courseCount;
+    uint64_t fingerprint = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < courseCount; ++i) {
+        // An index the pool cannot store leaves the course out rather than naming another section
+        bool stored = i < choice.size() && choice[i] >= 0 && choice[i] < NO_SECTION;
+        uint16_t section = stored ? static_cast<uint16_t>(choice[i]) : NO_SECTION;
+        sections[row + i] = section;
+
+        // FNV-1a over the indices
+        fingerprint = (fingerprint ^ section) * 0x100000001b3ULL;
+    }
+    fingerprints[handle] = fingerprint;
+    scores[handle] = score;
+}
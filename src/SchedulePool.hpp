@@ -0,0 +1,59 @@
+#ifndef SCHEDULE_POOL_HPP
+#define SCHEDULE_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact storage for many candidate schedules.
+// A schedule is one uint16 section index per course (course and section
+// numbering as in CompiledRequirements) with a cached fingerprint and score.
+// All schedules live in three flat arrays owned by the pool and are named by
+// a handle, so storing one costs 2 * courses + 12 bytes and no allocation once
+// the pool has grown; with five courses that is 22 bytes instead of a
+// Schedule with a vector of shared_ptrs. Slots can be overwritten in place,
+// which is how a top-K collector replaces its worst entry. Expand a handle
+// into a Schedule only to show or export it.
+class SchedulePool {
+public:
+    typedef uint32_t Handle;
+
+    // Marks a course with no section in the schedule
+    static const uint16_t NO_SECTION = 0xFFFF;
+
+    SchedulePool();
+
+    // Drops every schedule and fixes the number of courses per schedule
+    void reset(size_t courseCount);
+    void reserve(size_t schedules);
+
+    // choice[i] is the section index for course i or -1; indices must be below NO_SECTION,
+    // which CompiledRequirements guarantees by never allowing a section past that
+    Handle add(const std::vector<int>& choice, float score);
+    void assign(Handle handle, const std::vector<int>& choice, float score);
+
+    size_t size() const;
+    bool empty() const;
+    size_t getCourseCount() const;
+
+    int getSection(Handle handle, size_t courseIndex) const;
+    std::vector<int> getChoice(Handle handle) const;
+    uint64_t getFingerprint(Handle handle) const;
+    float getScore(Handle handle) const;
+
+    // Same sections for every course; the fingerprint rejects most pairs at once
+    bool equals(Handle a, Handle b) const;
+
+    // Storage used by one schedule, for sizing against a memory budget
+    size_t getBytesPerSchedule() const;
+
+private:
+    size_t courseCount;
+    std::vector<uint16_t> sections;
+    std::vector<uint64_t> fingerprints;
+    std::vector<float> scores;
+
+    void write(Handle handle, const std::vector<int>& choice, float score);
+};
+
+#endif // SCHEDULE_POOL_HPP
@@ -0,0 +1,241 @@
+#include "ScheduleRepairer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+
+namespace {
+
+// A class a released course can move to, and whether that moves it at all
+struct Candidate {
+    int classIndex;
+    int cost;  // 0 when the class holds the previous section
+    float score;
+};
+
+}
+
+ScheduleRepairer::ScheduleRepairer() {}
+
+void ScheduleRepairer::build(const std::vector<std::shared_ptr<Course>>& courses, const ScheduleSolver& solver) {
+    this->courses = courses;
+    classes.clear();
+    classOfSection.clear();
+    for (size_t i = 0; i < solver.getCourseCount(); ++i) {
+        classes.push_back(solver.getClasses(i));
+        size_t sectionCount = i < courses.size() ? courses[i]->getSections().size() : 0;
+        classOfSection.push_back(std::vector<int>(sectionCount, -1));
+        for (size_t k = 0; k < classes[i].size(); ++k) {
+            for (int member : classes[i][k].members) classOfSection[i][member] = static_cast<int>(k);
+        }
+    }
+    choice.clear();
+}
+
+RepairResult ScheduleRepairer::run(const std::vector<int>& previous, const std::vector<int>& pinned,
+                                   const RepairOptions& options) {
+    RepairResult result;
+    auto startTime = std::chrono::steady_clock::now();
+    auto elapsed = [&startTime]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    size_t courseCount = classes.size();
+    choice.assign(courseCount, -1);
+    std::vector<const MeetingPattern*> fixed(courseCount, nullptr);
+    std::vector<bool> isPinned(courseCount, false);
+    std::vector<bool> isFree(courseCount, false);
+
+    auto clashesWithFixed = [&](const MeetingPattern& pattern) {
+        for (size_t c = 0; c < courseCount; ++c) {
+            if (fixed[c] && fixed[c]->overlaps(pattern)) return true;
+        }
+        return false;
+    };
+
+    // Pins stand even where a requirement rules them out; two that clash leave nothing to repair
+    for (size_t c = 0; c < courseCount; ++c) {
+        int section = c < pinned.size() ? pinned[c] : -1;
+        if (section < 0 || section >= static_cast<int>(classOfSection[c].size())) continue;
+        const MeetingPattern* pattern = patternOf(c, section);
+        if (pattern && clashesWithFixed(*pattern)) {
+            result.seconds = elapsed();
+            return result;
+        }
+        choice[c] = section;
+        fixed[c] = pattern;
+        isPinned[c] = true;
+    }
+
+    // Everything else keeps its section unless that is gone, disallowed or now clashes
+    for (size_t c = 0; c < courseCount; ++c) {
+        if (isPinned[c]) continue;
+        if (classes[c].empty()) {
+            if (!courses[c]->getSections().empty()) {
+                result.seconds = elapsed();
+                return result;
+            }
+            continue;
+        }
+
+        int section = c < previous.size() ? previous[c] : -1;
+        bool keep = section >= 0 && section < static_cast<int>(classOfSection[c].size()) &&
+                    classOfSection[c][section] >= 0;
+        const MeetingPattern* pattern = keep ? classes[c][classOfSection[c][section]].pattern.get() : nullptr;
+        if (keep && !clashesWithFixed(*pattern)) {
+            choice[c] = section;
+            fixed[c] = pattern;
+        } else {
+            isFree[c] = true;
+        }
+    }
+
+    bool stopped = false;
+    bool found = false;
+    while (!found && !stopped) {
+        result.rounds++;
+        std::vector<int> freeCourses;
+        for (size_t c = 0; c < courseCount; ++c) {
+            if (isFree[c]) freeCourses.push_back(static_cast<int>(c));
+        }
+        result.neighborhood = freeCourses.size();
+
+        // Classes clear of everything fixed, staying put first and then by score
+        std::vector<std::vector<Candidate>> candidates(freeCourses.size());
+        bool placeable = true;
+        for (size_t f = 0; f < freeCourses.size(); ++f) {
+            int c = freeCourses[f];
+            int previousClass = c < static_cast<int>(previous.size()) && previous[c] >= 0 &&
+                                previous[c] < static_cast<int>(classOfSection[c].size())
+                                    ? classOfSection[c][previous[c]] : -1;
+            for (size_t k = 0; k < classes[c].size(); ++k) {
+                if (clashesWithFixed(*classes[c][k].pattern)) continue;
+                int cost = static_cast<int>(k) == previousClass ? 0 : 1;
+                candidates[f].push_back(Candidate{static_cast<int>(k), cost, classes[c][k].score});
+            }
+            std::sort(candidates[f].begin(), candidates[f].end(), [](const Candidate& a, const Candidate& b) {
+                return a.cost != b.cost ? a.cost < b.cost : a.score > b.score;
+            });
+            placeable = placeable && !candidates[f].empty();
+        }
+
+        if (placeable) {
+            // Fewest options first, with the best any suffix could still do
+            std::vector<size_t> order(freeCourses.size());
+            for (size_t f = 0; f < order.size(); ++f) order[f] = f;
+            std::stable_sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+                return candidates[a].size() < candidates[b].size();
+            });
+            size_t depthCount = order.size();
+            std::vector<int> suffixCost(depthCount + 1, 0);
+            std::vector<float> suffixScore(depthCount + 1, 0.0f);
+            for (size_t d = depthCount; d-- > 0;) {
+                int cheapest = candidates[order[d]][0].cost;
+                float best = candidates[order[d]][0].score;
+                for (const Candidate& candidate : candidates[order[d]]) {
+                    cheapest = std::min(cheapest, candidate.cost);
+                    best = std::max(best, candidate.score);
+                }
+                suffixCost[d] = suffixCost[d + 1] + cheapest;
+                suffixScore[d] = suffixScore[d + 1] + best;
+            }
+
+            std::vector<size_t> picks(depthCount, 0);
+            std::vector<size_t> bestPicks;
+            std::vector<const MeetingPattern*> chosen(depthCount, nullptr);
+            int bestCost = std::numeric_limits<int>::max();
+            float bestScore = 0.0f;
+
+            std::function<void(size_t, int, float)> searchFrom = [&](size_t depth, int cost, float score) {
+                if (depth == depthCount) {
+                    // The bound test on the way down already made this the best so far
+                    bestCost = cost;
+                    bestScore = score;
+                    bestPicks = picks;
+                    return;
+                }
+
+                const std::vector<Candidate>& moves = candidates[order[depth]];
+                for (size_t i = 0; i < moves.size() && !stopped; ++i) {
+                    const Candidate& candidate = moves[i];
+                    int nextCost = cost + candidate.cost;
+                    float nextScore = score + candidate.score;
+                    if (nextCost + suffixCost[depth + 1] > bestCost ||
+                        (nextCost + suffixCost[depth + 1] == bestCost &&
+                         nextScore + suffixScore[depth + 1] <= bestScore)) {
+                        continue;
+                    }
+
+                    result.nodes++;
+                    if (options.timeLimitSeconds > 0.0 && (result.nodes & 1023) == 0 &&
+                        elapsed() > options.timeLimitSeconds) {
+                        stopped = true;
+                        return;
+                    }
+
+                    const MeetingPattern* pattern =
+                        classes[freeCourses[order[depth]]][candidate.classIndex].pattern.get();
+                    bool clash = false;
+                    for (size_t d = 0; d < depth && !clash; ++d) clash = chosen[d]->overlaps(*pattern);
+                    if (clash) continue;
+
+                    chosen[depth] = pattern;
+                    picks[depth] = i;
+                    searchFrom(depth + 1, nextCost, nextScore);
+                }
+            };
+            searchFrom(0, 0, 0.0f);
+
+            if (!bestPicks.empty() || depthCount == 0) {
+                found = true;
+                for (size_t d = 0; d < depthCount; ++d) {
+                    int c = freeCourses[order[d]];
+                    const Candidate& candidate = candidates[order[d]][bestPicks[d]];
+                    // Unmoved courses keep the very section they had, not just its class
+                    choice[c] = candidate.cost == 0 ? previous[c] : classes[c][candidate.classIndex].members.front();
+                }
+                break;
+            }
+        }
+        if (stopped) break;
+
+        // Release the kept courses that block an option of a course still to place
+        bool grew = false;
+        for (size_t c = 0; c < courseCount; ++c) {
+            if (isPinned[c] || isFree[c] || !fixed[c]) continue;
+            bool blocks = false;
+            for (size_t f = 0; f < freeCourses.size() && !blocks; ++f) {
+                for (const SectionClass& sectionClass : classes[freeCourses[f]]) {
+                    if (sectionClass.pattern->overlaps(*fixed[c])) {
+                        blocks = true;
+                        break;
+                    }
+                }
+            }
+            if (blocks) {
+                isFree[c] = true;
+                fixed[c] = nullptr;
+                choice[c] = -1;
+                grew = true;
+            }
+        }
+        if (!grew) break;
+    }
+
+    result.complete = found;
+    result.budgetExhausted = stopped;
+    for (size_t c = 0; c < courseCount; ++c) {
+        int before = c < previous.size() ? previous[c] : -1;
+        if (choice[c] != before) result.changed++;
+    }
+    result.seconds = elapsed();
+    return result;
+}
+
+const std::vector<int>& ScheduleRepairer::getChoice() const {
+    return choice;
+}
+
+const MeetingPattern* ScheduleRepairer::patternOf(size_t course, int section) const {
+    return courses[course]->getSections()[section]->getMeetingPattern().get();
+}
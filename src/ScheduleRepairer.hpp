@@ -0,0 +1,54 @@
+#ifndef SCHEDULE_REPAIRER_HPP
+#define SCHEDULE_REPAIRER_HPP
+
+#include "ScheduleSolver.hpp"
+#include <vector>
+#include <memory>
+
+struct RepairOptions {
+    double timeLimitSeconds = 0.0;  // zero means unlimited
+};
+
+struct RepairResult {
+    bool complete = false;         // every course with sections got one
+    bool budgetExhausted = false;  // stopped at the time limit; churn may not be minimal
+    size_t changed = 0;            // courses whose section differs from the previous schedule
+    size_t neighborhood = 0;       // courses the final search was allowed to change
+    size_t rounds = 0;             // searches run, one more each time the neighborhood grew
+    size_t nodes = 0;
+    double seconds = 0.0;
+};
+
+// Re-solves a schedule after an edit instead of starting over. Pinned
+// sections never move and every other course keeps its previous section
+// while that is still allowed and clash-free. Only the courses that lost
+// their section are searched, for the fewest changes first and the best
+// preference score second. When they cannot all be placed, the kept courses
+// that block one of their options are released as well and the search runs
+// again, so the neighborhood grows only as far as the edit reaches.
+class ScheduleRepairer {
+public:
+    ScheduleRepairer();
+
+    void build(const std::vector<std::shared_ptr<Course>>& courses, const ScheduleSolver& solver);
+
+    // previous[i] and pinned[i] are section indices of course i, -1 for none
+    RepairResult run(const std::vector<int>& previous, const std::vector<int>& pinned,
+                     const RepairOptions& options = RepairOptions());
+
+    // Section index per course from the last run, -1 for none
+    const std::vector<int>& getChoice() const;
+
+private:
+    std::vector<std::shared_ptr<Course>> courses;
+    std::vector<std::vector<SectionClass>> classes;
+
+    // Per course, the class of every section, -1 when no class admits it
+    std::vector<std::vector<int>> classOfSection;
+
+    std::vector<int> choice;
+
+    const MeetingPattern* patternOf(size_t course, int section) const;
+};
+
+#endif // SCHEDULE_REPAIRER_HPP
@@ -0,0 +1,460 @@
+#include "ScheduleSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+
+ScheduleSolver::ScheduleSolver()
+    : infeasible(false), nodeCount(0), pruning(false), keepTies(false), pruneThreshold(0.0f), tieSlack(0.0f), compactness(nullptr) {}
+
+void ScheduleSolver::build(const std::vector<std::shared_ptr<Course>>& courses,
+                           const CompiledRequirements& requirements,
+                           const ScoreModel& scoreModel) {
+    classes.assign(courses.size(), std::vector<SectionClass>());
+    infeasible = false;
+    nodeCount = 0;
+
+    for (size_t i = 0; i < courses.size(); ++i) {
+        const auto& sections = courses[i]->getSections();
+        const SectionMask& allowed = requirements.getAllowedSections(i);
+
+        // Sections with the same meetings, requirement verdict and score collapse into one class
+        std::map<std::pair<std::vector<uint32_t>, float>, size_t> classByKey;
+        for (size_t j = 0; j < sections.size(); ++j) {
+            auto pattern = sections[j]->getMeetingPattern();
+            if (!allowed.test(j) || !pattern) continue;
+
+            float score = scoreModel.getSectionScore(i, static_cast<int>(j));
+            std::vector<uint32_t> meetings;
+            for (PackedTimeSlot meeting : pattern->getMeetings()) meetings.push_back(meeting.raw());
+            auto key = std::make_pair(meetings, score);
+
+            auto it = classByKey.find(key);
+            if (it == classByKey.end()) {
+                classByKey[key] = classes[i].size();
+                classes[i].push_back(SectionClass{static_cast<int>(i), pattern, score, {static_cast<int>(j)}});
+            } else {
+                classes[i][it->second].members.push_back(static_cast<int>(j));
+            }
+        }
+
+        // A course that has sections (or requirements) but nothing left to pick cannot be scheduled
+        if (classes[i].empty() && (!sections.empty() || requirements.isConstrained(i))) {
+            infeasible = true;
+        }
+    }
+
+    computeConflicts();
+    orderCourses();
+}
+
+void ScheduleSolver::setSectionOrder(const std::vector<std::vector<int>>& rank) {
+    for (size_t i = 0; i < classes.size() && i < rank.size(); ++i) {
+        const auto& courseRank = rank[i];
+        auto rankOf = [&courseRank](int section) {
+            return static_cast<size_t>(section) < courseRank.size() ? courseRank[section] : section;
+        };
+
+        for (auto& sectionClass : classes[i]) {
+            std::sort(sectionClass.members.begin(), sectionClass.members.end(),
+                      [&](int a, int b) { return rankOf(a) < rankOf(b); });
+        }
+        std::sort(classes[i].begin(), classes[i].end(),
+                  [&](const SectionClass& a, const SectionClass& b) {
+                      return rankOf(a.members.front()) < rankOf(b.members.front());
+                  });
+    }
+
+    // Class positions changed, so the global numbering has to be rebuilt
+    computeConflicts();
+}
+
+SearchResult ScheduleSolver::search(const std::function<bool(const std::vector<int>&, float)>& onSolution,
+                                    const SearchLimits& limits) {
+    SearchResult result;
+    auto startTime = std::chrono::steady_clock::now();
+    nodeCount = 0;
+    pruning = false;
+    if (infeasible) {
+        result.completed = true;
+        return result;
+    }
+
+    // suffixBest[d]: best score still available from courseOrder[d] onwards
+    std::vector<float> suffixBest(courseOrder.size() + 1, 0.0f);
+    for (size_t d = courseOrder.size(); d-- > 0;) {
+        float best = 0.0f;
+        for (const auto& sectionClass : classes[courseOrder[d]]) {
+            best = std::max(best, sectionClass.score);
+        }
+        suffixBest[d] = suffixBest[d + 1] + best;
+    }
+
+    // Week occupancy of every class, and what the courses from each depth on could still cover
+    const int DAYS = CompactnessModel::DAYS;
+    bool compact = compactness && compactness->isActive();
+    std::vector<uint64_t> classWeek(compact ? conflicts.size() * DAYS : 0, 0);
+    std::vector<std::vector<uint64_t>> reachable(courseOrder.size() + 1, std::vector<uint64_t>(DAYS, 0));
+    if (compact) {
+        for (size_t d = courseOrder.size(); d-- > 0;) {
+            reachable[d] = reachable[d + 1];
+            int course = courseOrder[d];
+            for (size_t k = 0; k < classes[course].size(); ++k) {
+                uint64_t* week = &classWeek[globalIds[course][k] * DAYS];
+                CompactnessModel::addToWeek(*classes[course][k].pattern, week);
+                for (int day = 0; day < DAYS; ++day) reachable[d][day] |= week[day];
+            }
+        }
+    }
+    uint64_t days[DAYS] = {0, 0, 0, 0, 0};
+
+    std::vector<int> blocked(conflicts.size(), 0);
+    std::vector<int> choice(classes.size(), -1);
+    bool stopped = false;
+    bool limitHit = false;
+    bool haveSolution = false;
+
+    // Largest optimistic score among subtrees left unexplored because of a stop
+    float frontierBound = -std::numeric_limits<float>::infinity();
+
+    std::function<void(size_t, float)> searchFrom;
+    searchFrom = [&](size_t depth, float prefixScore) {
+        if (depth == courseOrder.size()) {
+            if (compact) prefixScore -= compactness->penalty(days);
+            result.solutions++;
+            if (!haveSolution || prefixScore > result.bestScore) {
+                result.bestScore = prefixScore;
+                haveSolution = true;
+            }
+            if (!onSolution(choice, prefixScore)) {
+                stopped = true;
+            }
+            return;
+        }
+
+        int course = courseOrder[depth];
+        if (classes[course].empty()) {
+            searchFrom(depth + 1, prefixScore);
+            return;
+        }
+
+        for (size_t k = 0; k < classes[course].size(); ++k) {
+            int id = globalIds[course][k];
+            if (blocked[id] > 0) continue;
+
+            float optimistic = prefixScore + classes[course][k].score + suffixBest[depth + 1];
+            uint64_t daysBefore[DAYS];
+            std::copy(days, days + DAYS, daysBefore);
+            if (compact) {
+                // Placing the class can only add fragmentation that later courses cannot repair
+                for (int day = 0; day < DAYS; ++day) days[day] |= classWeek[id * DAYS + day];
+                optimistic -= compactness->lowerBound(days, reachable[depth + 1].data());
+                std::copy(daysBefore, daysBefore + DAYS, days);
+            }
+            if (stopped) {
+                // Remember what was left behind so the caller gets a valid bound
+                frontierBound = std::max(frontierBound, optimistic);
+                continue;
+            }
+            if (pruning && (keepTies ? optimistic < pruneThreshold - tieSlack : optimistic <= pruneThreshold)) continue;
+
+            nodeCount++;
+            bool polling = (nodeCount & 1023) == 0;
+            if (polling && limits.incumbent) {
+                float shared = limits.incumbent->load(std::memory_order_relaxed);
+                if (!pruning || shared > pruneThreshold) setPruneThreshold(shared);
+            }
+            if ((limits.nodeLimit > 0 && nodeCount > limits.nodeLimit) ||
+                (polling && limits.cancel && limits.cancel->load(std::memory_order_relaxed)) ||
+                (limits.timeLimitSeconds > 0.0 && polling &&
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >
+                     limits.timeLimitSeconds)) {
+                stopped = true;
+                limitHit = true;
+                frontierBound = std::max(frontierBound, optimistic);
+                continue;
+            }
+
+            choice[course] = static_cast<int>(k);
+            for (int other : conflicts[id]) blocked[other]++;
+            if (compact) {
+                for (int day = 0; day < DAYS; ++day) days[day] |= classWeek[id * DAYS + day];
+            }
+
+            searchFrom(depth + 1, prefixScore + classes[course][k].score);
+
+            std::copy(daysBefore, daysBefore + DAYS, days);
+            for (int other : conflicts[id]) blocked[other]--;
+            choice[course] = -1;
+        }
+    };
+
+    searchFrom(0, 0.0f);
+
+    result.nodes = nodeCount;
+    result.completed = !limitHit;
+    if (limitHit) {
+        result.bound = std::max(result.bestScore, frontierBound);
+    } else if (stopped) {
+        // Stopped by the caller: nothing is known beyond the root bound
+        result.bound = std::max(result.bestScore, getRootBound());
+        result.completed = false;
+    } else {
+        result.bound = result.bestScore;
+    }
+    if (pruning && !limitHit && !stopped) {
+        // Pruned subtrees could not beat the threshold
+        result.bound = std::max(result.bestScore, pruneThreshold);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+bool ScheduleSolver::advance(SearchCursor& cursor) const {
+    if (cursor.finished) return false;
+
+    if (!cursor.started) {
+        cursor.started = true;
+        cursor.choice.assign(classes.size(), -1);
+        cursor.nextClass.assign(courseOrder.size() + 1, 0);
+        cursor.blocked.assign(conflicts.size(), 0);
+        cursor.depth = 0;
+        if (infeasible) {
+            cursor.finished = true;
+            return false;
+        }
+    } else if (!retreat(cursor)) {
+        // The last solution was the final leaf
+        return false;
+    }
+
+    while (cursor.depth < courseOrder.size()) {
+        int course = courseOrder[cursor.depth];
+        if (classes[course].empty()) {
+            cursor.depth++;
+            continue;
+        }
+
+        size_t k = cursor.nextClass[cursor.depth];
+        while (k < classes[course].size() && cursor.blocked[globalIds[course][k]] > 0) ++k;
+
+        if (k < classes[course].size()) {
+            cursor.choice[course] = static_cast<int>(k);
+            cursor.nextClass[cursor.depth] = k + 1;
+            for (int other : conflicts[globalIds[course][k]]) cursor.blocked[other]++;
+            cursor.depth++;
+            cursor.nextClass[cursor.depth] = 0;
+        } else {
+            cursor.nextClass[cursor.depth] = 0;
+            if (!retreat(cursor)) return false;
+        }
+    }
+    return true;
+}
+
+bool ScheduleSolver::retreat(SearchCursor& cursor) const {
+    // Undo the deepest real choice so its course can try its next class
+    while (cursor.depth > 0) {
+        cursor.depth--;
+        int course = courseOrder[cursor.depth];
+        if (classes[course].empty()) continue;
+
+        int k = cursor.choice[course];
+        for (int other : conflicts[globalIds[course][k]]) cursor.blocked[other]--;
+        cursor.choice[course] = -1;
+        return true;
+    }
+    cursor.finished = true;
+    return false;
+}
+
+void ScheduleSolver::setCompactness(const CompactnessModel* model) {
+    compactness = model;
+}
+
+void ScheduleSolver::setPruneThreshold(float threshold) {
+    pruning = true;
+    pruneThreshold = threshold;
+    tieSlack = 1e-5f * std::max(1.0f, std::fabs(threshold));
+}
+
+void ScheduleSolver::setKeepTies(bool keep) {
+    keepTies = keep;
+}
+
+void ScheduleSolver::sortMembers() {
+    for (auto& courseClasses : classes) {
+        for (auto& sectionClass : courseClasses) {
+            std::sort(sectionClass.members.begin(), sectionClass.members.end());
+        }
+    }
+}
+
+float ScheduleSolver::getRootBound() const {
+    float bound = 0.0f;
+    for (const auto& courseClasses : classes) {
+        float best = 0.0f;
+        for (const auto& sectionClass : courseClasses) {
+            best = std::max(best, sectionClass.score);
+        }
+        bound += best;
+    }
+    return bound;
+}
+
+std::vector<int> ScheduleSolver::expandFirst(const std::vector<int>& classChoice) const {
+    std::vector<int> sections(classChoice.size(), -1);
+    for (size_t i = 0; i < classChoice.size(); ++i) {
+        if (classChoice[i] >= 0) {
+            sections[i] = classes[i][classChoice[i]].members.front();
+        }
+    }
+    return sections;
+}
+
+void ScheduleSolver::expand(const std::vector<int>& classChoice, size_t limit,
+                            std::vector<std::vector<int>>& out) const {
+    // Odometer over the members of every chosen class
+    std::vector<size_t> position(classChoice.size(), 0);
+    for (size_t produced = 0; produced < limit; ++produced) {
+        std::vector<int> sections(classChoice.size(), -1);
+        for (size_t i = 0; i < classChoice.size(); ++i) {
+            if (classChoice[i] >= 0) {
+                sections[i] = classes[i][classChoice[i]].members[position[i]];
+            }
+        }
+        out.push_back(sections);
+
+        size_t i = 0;
+        for (; i < classChoice.size(); ++i) {
+            if (classChoice[i] < 0) continue;
+            if (++position[i] < classes[i][classChoice[i]].members.size()) break;
+            position[i] = 0;
+        }
+        if (i == classChoice.size()) break;
+    }
+}
+
+double ScheduleSolver::countExpansions(const std::vector<int>& classChoice) const {
+    double total = 1.0;
+    for (size_t i = 0; i < classChoice.size(); ++i) {
+        if (classChoice[i] >= 0) {
+            total *= static_cast<double>(classes[i][classChoice[i]].members.size());
+        }
+    }
+    return total;
+}
+
+std::vector<std::vector<int>> ScheduleSolver::getComponents() const {
+    // Union-find over courses, joined by every class conflict
+    std::vector<int> parent(classes.size());
+    for (size_t i = 0; i < parent.size(); ++i) parent[i] = static_cast<int>(i);
+    auto find = [&parent](int course) {
+        while (parent[course] != course) {
+            parent[course] = parent[parent[course]];
+            course = parent[course];
+        }
+        return course;
+    };
+
+    std::vector<int> owner(conflicts.size(), 0);
+    for (size_t i = 0; i < globalIds.size(); ++i) {
+        for (int id : globalIds[i]) owner[id] = static_cast<int>(i);
+    }
+    for (size_t id = 0; id < conflicts.size(); ++id) {
+        for (int other : conflicts[id]) {
+            int a = find(owner[id]);
+            int b = find(owner[other]);
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    std::vector<std::vector<int>> components;
+    std::vector<int> componentOf(classes.size(), -1);
+    for (size_t i = 0; i < classes.size(); ++i) {
+        int root = find(static_cast<int>(i));
+        if (componentOf[root] < 0) {
+            componentOf[root] = static_cast<int>(components.size());
+            components.push_back(std::vector<int>());
+        }
+        components[componentOf[root]].push_back(static_cast<int>(i));
+    }
+    return components;
+}
+
+size_t ScheduleSolver::getCourseCount() const {
+    return classes.size();
+}
+
+const std::vector<int>& ScheduleSolver::getCourseOrder() const {
+    return courseOrder;
+}
+
+const std::vector<SectionClass>& ScheduleSolver::getClasses(size_t courseIndex) const {
+    return classes[courseIndex];
+}
+
+bool ScheduleSolver::isInfeasible() const {
+    return infeasible;
+}
+
+size_t ScheduleSolver::getNodeCount() const {
+    return nodeCount;
+}
+
+void ScheduleSolver::computeConflicts() {
+    globalIds.assign(classes.size(), std::vector<int>());
+    std::vector<std::pair<size_t, size_t>> owners;
+    for (size_t i = 0; i < classes.size(); ++i) {
+        for (size_t k = 0; k < classes[i].size(); ++k) {
+            globalIds[i].push_back(static_cast<int>(owners.size()));
+            owners.push_back(std::make_pair(i, k));
+        }
+    }
+
+    // Only classes meeting on the same day can overlap, so compare within day buckets.
+    // A class meeting on several days sits in several buckets; a pair is compared in
+    // the first bucket both share only.
+    conflicts.assign(owners.size(), std::vector<int>());
+    std::vector<std::vector<int>> byDay(MeetingPattern::DAYS);
+    std::vector<unsigned> dayMasks(owners.size(), 0);
+    for (size_t id = 0; id < owners.size(); ++id) {
+        const auto& sectionClass = classes[owners[id].first][owners[id].second];
+        dayMasks[id] = sectionClass.pattern->getDayMask();
+        for (int day = 0; day < MeetingPattern::DAYS; ++day) {
+            if (dayMasks[id] & (1u << day)) byDay[day].push_back(static_cast<int>(id));
+        }
+    }
+
+    for (int day = 0; day < MeetingPattern::DAYS; ++day) {
+        const auto& bucket = byDay[day];
+        for (size_t a = 0; a < bucket.size(); ++a) {
+            for (size_t b = a + 1; b < bucket.size(); ++b) {
+                const auto& first = owners[bucket[a]];
+                const auto& second = owners[bucket[b]];
+                if (first.first == second.first) continue;
+
+                unsigned shared = dayMasks[bucket[a]] & dayMasks[bucket[b]];
+                if (__builtin_ctz(shared) != day) continue;
+
+                const auto& patternA = *classes[first.first][first.second].pattern;
+                const auto& patternB = *classes[second.first][second.second].pattern;
+                if (patternA.overlaps(patternB)) {
+                    conflicts[bucket[a]].push_back(bucket[b]);
+                    conflicts[bucket[b]].push_back(bucket[a]);
+                }
+            }
+        }
+    }
+}
+
+void ScheduleSolver::orderCourses() {
+    courseOrder.clear();
+    for (size_t i = 0; i < classes.size(); ++i) {
+        courseOrder.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(courseOrder.begin(), courseOrder.end(), [this](int a, int b) {
+        return classes[a].size() < classes[b].size();
+    });
+}
@@ -0,0 +1,148 @@
+#ifndef SCHEDULE_SOLVER_HPP
+#define SCHEDULE_SOLVER_HPP
+
+#include "Models.hpp"
+#include "RequirementMask.hpp"
+#include "ScoreModel.hpp"
+#include "CompactnessModel.hpp"
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <functional>
+
+// Sections of one course that no active requirement or preference can tell
+// apart: same meetings, same requirement verdict and same preference score.
+// The solver branches on a class once and expands it to concrete sections
+// only when a schedule is produced.
+struct SectionClass {
+    int courseIndex;
+    std::shared_ptr<MeetingPattern> pattern;
+    float score;              // preference score shared by every member
+    std::vector<int> members; // section indices, in value order
+};
+
+// Budgets for one search; zero means unlimited
+struct SearchLimits {
+    double timeLimitSeconds = 0.0;
+    size_t nodeLimit = 0;
+
+    // Searches running side by side: setting cancel stops this one like a
+    // limit, and incumbent is a score found elsewhere that only better
+    // subtrees need to beat. Both are polled every 1024 nodes.
+    const std::atomic<bool>* cancel = nullptr;
+    const std::atomic<float>* incumbent = nullptr;
+};
+
+struct SearchResult {
+    size_t solutions = 0;
+    size_t nodes = 0;
+    bool completed = false;   // the whole (unpruned) space was explored
+    float bestScore = 0.0f;   // best score reported to the callback
+    float bound = 0.0f;       // no solution can score above this
+    double seconds = 0.0;
+};
+
+// Resumable position of a depth-first enumeration, advanced by ScheduleSolver::advance()
+struct SearchCursor {
+    std::vector<int> choice;        // class index per course, -1 for none
+    std::vector<size_t> nextClass;  // per depth, the next class to try
+    std::vector<int> blocked;
+    size_t depth = 0;
+    bool started = false;
+    bool finished = false;
+};
+
+// Depth-first branch and bound over section equivalence classes.
+// Solutions are reported as one class index per course (-1 for a course
+// with no sections) together with their preference score; expand() turns
+// them into section indices. Once the caller sets a prune threshold, only
+// subtrees that can still beat it are explored. When a limit stops the
+// search early, the result carries the best bound over the unexplored
+// frontier so callers can report the optimality gap.
+class ScheduleSolver {
+public:
+    ScheduleSolver();
+
+    void build(const std::vector<std::shared_ptr<Course>>& courses,
+               const CompiledRequirements& requirements,
+               const ScoreModel& scoreModel);
+
+    // Optional value order: rank[i][j] is the position of section j of course i
+    void setSectionOrder(const std::vector<std::vector<int>>& rank);
+
+    // Calls onSolution for every conflict-free class assignment until it returns
+    // false or a limit is hit
+    SearchResult search(const std::function<bool(const std::vector<int>&, float)>& onSolution,
+                        const SearchLimits& limits = SearchLimits());
+
+    // Pull-based enumeration: moves the cursor to the next conflict-free class
+    // assignment, in the same order as search(), and returns false when done
+    bool advance(SearchCursor& cursor) const;
+
+    // Subtract the compactness penalty from every score; nullptr turns it off.
+    // The model must outlive the searches that use it.
+    void setCompactness(const CompactnessModel* model);
+
+    // Skip subtrees whose optimistic score is not above the threshold; callable from onSolution
+    void setPruneThreshold(float threshold);
+
+    // With keepTies, subtrees that can at best tie the threshold are searched too,
+    // with a little slack for bounds rounding differently from the leaves, so
+    // every solution scoring at least the threshold is reported
+    void setKeepTies(bool keep);
+
+    // Members of every class in ascending section order, leaving the class order
+    // alone, so expand() lists a class assignment's schedules in the same order
+    // whatever section order was set
+    void sortMembers();
+
+    // Optimistic score of the whole problem: every course at its best class
+    float getRootBound() const;
+
+    // Concrete section choice using the first member of every class
+    std::vector<int> expandFirst(const std::vector<int>& classChoice) const;
+
+    // Up to limit concrete section choices covered by one class assignment
+    void expand(const std::vector<int>& classChoice, size_t limit,
+                std::vector<std::vector<int>>& out) const;
+
+    // Number of concrete schedules a class assignment stands for
+    double countExpansions(const std::vector<int>& classChoice) const;
+
+    // Groups of courses whose classes can clash, ascending; courses in different
+    // groups never constrain each other and can be searched separately
+    std::vector<std::vector<int>> getComponents() const;
+
+    size_t getCourseCount() const;
+    // Courses in branching order, the order leaf scores are added up in
+    const std::vector<int>& getCourseOrder() const;
+    const std::vector<SectionClass>& getClasses(size_t courseIndex) const;
+    bool isInfeasible() const;
+    size_t getNodeCount() const;
+
+private:
+    std::vector<std::vector<SectionClass>> classes;
+
+    // Classes are numbered globally so conflicts can be tracked in flat arrays
+    std::vector<std::vector<int>> globalIds;
+    std::vector<std::vector<int>> conflicts;
+
+    // Branching order over courses, fewest classes first
+    std::vector<int> courseOrder;
+
+    bool infeasible;
+    size_t nodeCount;
+
+    bool pruning;
+    bool keepTies;
+    float pruneThreshold;
+    float tieSlack;
+
+    const CompactnessModel* compactness;
+
+    void computeConflicts();
+    void orderCourses();
+    bool retreat(SearchCursor& cursor) const;
+};
+
+#endif // SCHEDULE_SOLVER_HPP
@@ -0,0 +1,77 @@
+#include "ScheduleStream.hpp"
+
+// ScheduleStream::iterator implementation
+ScheduleStream::iterator::iterator() : stream(nullptr) {}
+
+ScheduleStream::iterator::iterator(ScheduleStream* stream) : stream(stream) {
+    ++(*this);
+}
+
+ScheduleStream::iterator::reference ScheduleStream::iterator::operator*() const {
+    return current;
+}
+
+ScheduleStream::iterator::pointer ScheduleStream::iterator::operator->() const {
+    return &current;
+}
+
+ScheduleStream::iterator& ScheduleStream::iterator::operator++() {
+    if (stream && !stream->next(current)) {
+        stream = nullptr;
+        current = nullptr;
+    }
+    return *this;
+}
+
+bool ScheduleStream::iterator::operator==(const iterator& other) const {
+    return stream == other.stream && current == other.current;
+}
+
+bool ScheduleStream::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+// ScheduleStream implementation
+ScheduleStream::ScheduleStream() : expanding(false) {}
+
+ScheduleStream::ScheduleStream(const std::vector<std::shared_ptr<Course>>& courses,
+                               std::shared_ptr<const ScheduleSolver> solver)
+    : courses(courses), solver(solver), expanding(false) {}
+
+bool ScheduleStream::next(std::shared_ptr<Schedule>& schedule) {
+    if (!solver) return false;
+
+    // Step the odometer over the current class members, or move on to the next class assignment
+    size_t i = 0;
+    if (expanding) {
+        for (; i < cursor.choice.size(); ++i) {
+            if (cursor.choice[i] < 0) continue;
+            if (++position[i] < solver->getClasses(i)[cursor.choice[i]].members.size()) break;
+            position[i] = 0;
+        }
+    }
+    if (!expanding || i == cursor.choice.size()) {
+        if (!solver->advance(cursor)) {
+            expanding = false;
+            return false;
+        }
+        position.assign(cursor.choice.size(), 0);
+        expanding = true;
+    }
+
+    schedule = std::make_shared<Schedule>();
+    for (size_t course = 0; course < cursor.choice.size() && course < courses.size(); ++course) {
+        if (cursor.choice[course] < 0) continue;
+        int section = solver->getClasses(course)[cursor.choice[course]].members[position[course]];
+        schedule->addSection(courses[course]->getSections()[section]);
+    }
+    return true;
+}
+
+ScheduleStream::iterator ScheduleStream::begin() {
+    return iterator(this);
+}
+
+ScheduleStream::iterator ScheduleStream::end() {
+    return iterator();
+}
@@ -0,0 +1,63 @@
+#ifndef SCHEDULE_STREAM_HPP
+#define SCHEDULE_STREAM_HPP
+
+#include "Models.hpp"
+#include "ScheduleSolver.hpp"
+#include <vector>
+#include <memory>
+#include <iterator>
+
+// Pull-based sequence of valid schedules.
+// Each next() resumes the solver's depth-first enumeration from an explicit
+// cursor and expands the current class assignment one concrete schedule at a
+// time, so only the schedule being handed out is ever materialized. A
+// consumer can stop at any point; memory use does not depend on how many
+// schedules exist. The stream keeps its own copy of the solver, so it stays
+// valid when the Scheduler regenerates.
+class ScheduleStream {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::shared_ptr<Schedule> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::shared_ptr<Schedule>* pointer;
+        typedef const std::shared_ptr<Schedule>& reference;
+
+        iterator();
+        explicit iterator(ScheduleStream* stream);
+
+        reference operator*() const;
+        pointer operator->() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        ScheduleStream* stream;
+        std::shared_ptr<Schedule> current;
+    };
+
+    // An empty stream
+    ScheduleStream();
+    ScheduleStream(const std::vector<std::shared_ptr<Course>>& courses,
+                   std::shared_ptr<const ScheduleSolver> solver);
+
+    // Next schedule, or false once every schedule has been produced
+    bool next(std::shared_ptr<Schedule>& schedule);
+
+    // Single-pass range over the remaining schedules
+    iterator begin();
+    iterator end();
+
+private:
+    std::vector<std::shared_ptr<Course>> courses;
+    std::shared_ptr<const ScheduleSolver> solver;
+    SearchCursor cursor;
+
+    // Position among the members of every chosen class
+    std::vector<size_t> position;
+    bool expanding;
+};
+
+#endif // SCHEDULE_STREAM_HPP
@@ -3,9 +3,64 @@
 
 #include "PQTree.hpp"
 #include "Models.hpp"
+#include "RequirementMask.hpp"
+#include "ScoreModel.hpp"
+#include "ScheduleSolver.hpp"
+#include "Timetabler.hpp"
+#include "RoomAssigner.hpp"
+#include "ConflictExplainer.hpp"
+#include "ScheduleCounter.hpp"
+#include "ScheduleStream.hpp"
+#include "SchedulePool.hpp"
+#include "ComponentSolver.hpp"
+#include "SolverPortfolio.hpp"
+#include "CatalogIndex.hpp"
+#include "ParetoSolver.hpp"
+#include "ScheduleRepairer.hpp"
+#include "TeacherValidator.hpp"
+#include "TeacherAssigner.hpp"
+#include "EnrollmentAllocator.hpp"
+#include "RegistrationSimulator.hpp"
+#include "PartialSolver.hpp"
 #include <vector>
 #include <memory>
 #include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// Budgets for generateSchedule(); zero means unlimited
+struct SolveOptions {
+    double timeLimitSeconds = 5.0;
+    size_t nodeLimit = 0;
+    size_t memoryLimitBytes = 0;  // cap on memory held by generated schedules
+    size_t maxSchedules = 50;
+    size_t threads = 1;           // more than one runs a portfolio of strategies in parallel,
+                                  // whose results depend on thread timing only when a limit
+                                  // stops it before a proof (see SolverPortfolio)
+    bool bestPartial = true;      // when nothing covers every course, keep the best partial schedule
+                                  // found within what the search left of the budgets
+};
+
+// Outcome of the last generateSchedule(), scores normalized like getScheduleScore()
+// less any compactness penalty
+struct SolveStats {
+    bool optimal = false;         // no schedule can score higher than the current one
+    bool budgetExhausted = false; // a time or node limit stopped the search
+    float bestScore = 0.0f;
+    float bound = 0.0f;           // upper bound on the score of any schedule
+    float gap = 0.0f;             // bound - bestScore
+    size_t nodes = 0;
+    size_t schedules = 0;
+    double seconds = 0.0;
+};
+
+// One schedule of a Pareto front with the objectives it trades off
+struct ParetoSchedule {
+    std::shared_ptr<Schedule> schedule;
+    float preferenceScore = 0.0f;  // normalized like getScheduleScore()
+    CompactnessReport compactness;
+};
 
 class Scheduler {
 public:
@@ -15,15 +70,122 @@ public:
     void addCourse(std::shared_ptr<Course> course);
     void addTeacher(std::shared_ptr<Teacher> teacher);
     void addSection(std::shared_ptr<Section> section);
+    void addRoom(std::shared_ptr<Room> room);
     
     // Add requirements/constraints
     void addRequirement(std::shared_ptr<Requirement> requirement);
     
+    // Add weighted soft preferences
+    void addPreference(std::shared_ptr<Preference> preference);
+    
     // Generate and get schedules
-    bool generateSchedule();
+    bool generateSchedule(const SolveOptions& options = SolveOptions());
+    const SolveStats& getLastSolveStats() const;
+    
+    // Per-strategy results of the last portfolio run, empty when it ran single-threaded
+    const std::vector<StrategyStats>& getLastPortfolioStats() const;
     std::shared_ptr<Schedule> getCurrentSchedule() const;
+    
+    // Kept schedules are stored compactly; these expand them on request
+    size_t getScheduleCount() const;
+    std::shared_ptr<Schedule> getSchedule(size_t index) const;
     std::vector<std::shared_ptr<Schedule>> getAllPossibleSchedules() const;
     
+    // Up to count kept schedules, best scoring first, as one student's ranked alternatives
+    std::vector<std::shared_ptr<Schedule>> getRankedSchedules(size_t count) const;
+    
+    // Every valid schedule of the current data, produced one at a time on demand
+    ScheduleStream streamSchedules();
+    
+    // Preference score of a schedule in [0, 1], from the last generation
+    float getScheduleScore(const Schedule& schedule) const;
+    
+    // Other sections of the same course that the last generation could not tell
+    // apart from this one: same meetings, requirement verdict and preference score
+    std::vector<std::shared_ptr<Section>> getEquivalentSections(const Section& section) const;
+    
+    // Weighted penalties for idle time, early starts and class days, traded off
+    // against preference weights when generating
+    void setCompactnessWeights(const CompactnessWeights& weights);
+    CompactnessReport getScheduleCompactness(const Schedule& schedule) const;
+    
+    // Every schedule that no other beats on all chosen objectives at once, best
+    // preference score first, instead of the single best weighted compromise
+    std::vector<ParetoSchedule> generateParetoFront(const ParetoOptions& options = ParetoOptions());
+    const ParetoResult& getLastParetoResult() const;
+    
+    // Pinned sections stay where they are when a schedule is repaired
+    void pinSection(std::shared_ptr<Section> section);
+    void unpinSection(std::shared_ptr<Section> section);
+    bool isPinned(const Section& section) const;
+    const std::vector<std::shared_ptr<Section>>& getPinnedSections() const;
+    
+    // Re-solves starting from a previous schedule after the data changed,
+    // moving as few courses as possible; the result becomes the current and
+    // only kept schedule. Returns whether it satisfies every requirement.
+    bool repairSchedule(const Schedule& previous, const RepairOptions& options = RepairOptions());
+    const RepairResult& getLastRepairResult() const;
+    
+    // Course weights for partial schedules when they are not weighed by credits;
+    // courses without one count 1
+    void setCoursePriority(std::shared_ptr<Course> course, float priority);
+    float getCoursePriority(const Course& course) const;
+    
+    // The schedule placing the most credits (or priority) when not every course
+    // fits; dropped courses are simply left out. Also becomes the current schedule.
+    std::shared_ptr<Schedule> generateBestPartialSchedule(const PartialOptions& options = PartialOptions());
+    const PartialResult& getLastPartialResult() const;
+    
+    // Teachers booked into overlapping sections or over their load limits,
+    // across every section. Kept up to date as sections are added; recheckAll
+    // also picks up sections whose teacher or times were edited in place.
+    TeacherValidation validateTeachers(bool recheckAll = false);
+    void setTeacherLoadLimits(const TeacherLoadLimits& limits);
+    
+    // Smallest set of courses and requirements that cannot all be met together,
+    // for when generateSchedule() finds nothing; within a budget it may not be minimal
+    ConflictExplanation explainConflicts(const ConflictOptions& options = ConflictOptions()) const;
+    
+    // Number of valid schedules: conflict-free section combinations that meet
+    // every requirement. Exact unless more than maxStates states or more than
+    // the time limit (zero for none) are needed.
+    ScheduleCount countValidSchedules(size_t maxStates = 1000000, double timeLimitSeconds = 0.0);
+    
+    // Valid schedules drawn uniformly at random, one per draw (may repeat)
+    std::vector<std::shared_ptr<Schedule>> sampleValidSchedules(size_t count, size_t maxStates = 1000000);
+    
+    // What fits around a schedule: sections that clash with none of its classes
+    // and the free stretches of at least minMinutes it leaves on each weekday
+    std::vector<std::shared_ptr<Section>> findFittingSections(const Schedule& schedule, bool otherCoursesOnly = true);
+    std::vector<TimeSlot> findFreeWindows(const Schedule& schedule, int minMinutes,
+                                          int dayStartHour = 8, int dayEndHour = 22) const;
+    
+    // Institution timetabling: give every section without a time slot a block
+    // that clashes with no other section of its teacher or cohort
+    void addCohort(const std::vector<std::shared_ptr<Section>>& cohort);
+    TimetableResult assignTimeSlots(const TimetableOptions& options = TimetableOptions());
+    
+    // Room assignment, run once the section times are fixed
+    RoomAssignmentResult assignRooms();
+    
+    // Qualified teachers for sections without one, or whose teacher breaks a
+    // TeacherRequirement, without double booking anyone
+    TeacherAssignmentResult assignTeachers(const TeacherAssignmentOptions& options = TeacherAssignmentOptions());
+    
+    // Seats for a batch of students, each with ranked alternative schedules,
+    // within the section capacities. Full sections are left out of later solves.
+    EnrollmentResult allocateSeats(const std::vector<std::vector<std::shared_ptr<Schedule>>>& students,
+                                   const EnrollmentOptions& options = EnrollmentOptions());
+    
+    // Many simulated students registering against these courses at once, for
+    // capacity planning: latency histograms, throughput and how many got seats
+    RushResult simulateRegistrationRush(const RushOptions& options = RushOptions());
+    
+    // Seed for every random choice the scheduler makes; equal seeds give equal
+    // results, except from a portfolio run on several threads that a limit stops
+    // before it proves its result
+    void setSeed(uint64_t seed);
+    
     // Clear all data
     void clear();
     
@@ -31,31 +193,120 @@ public:
     const std::vector<std::shared_ptr<Course>>& getCourses() const;
     const std::vector<std::shared_ptr<Teacher>>& getTeachers() const;
     const std::vector<std::shared_ptr<Section>>& getSections() const;
+    const std::vector<std::shared_ptr<Room>>& getRooms() const;
     const std::vector<std::shared_ptr<Requirement>>& getRequirements() const;
+    const std::vector<std::shared_ptr<Preference>>& getPreferences() const;
+    
+    // Lookup by course code or id in constant time; null when nothing matches.
+    // With duplicate codes or ids the first one added wins.
+    std::shared_ptr<Course> findCourse(const std::string& code) const;
+    std::shared_ptr<Teacher> findTeacher(const std::string& id) const;
+    std::shared_ptr<Section> findSection(const std::string& id) const;
+    std::shared_ptr<Room> findRoom(const std::string& id) const;
     
 private:
     std::vector<std::shared_ptr<Course>> courses;
     std::vector<std::shared_ptr<Teacher>> teachers;
     std::vector<std::shared_ptr<Section>> sections;
+    std::vector<std::shared_ptr<Room>> rooms;
     std::vector<std::shared_ptr<Requirement>> requirements;
+    std::vector<std::shared_ptr<Preference>> preferences;
+    std::vector<std::vector<std::shared_ptr<Section>>> cohorts;
+    std::vector<std::shared_ptr<Section>> pinnedSections;
+    std::unordered_map<const Course*, float> coursePriorities;
+    
+    // Hash indices kept alongside the lists above, so adding n entities is O(n)
+    std::unordered_map<std::string, std::shared_ptr<Course>> coursesByCode;
+    std::unordered_map<std::string, std::shared_ptr<Teacher>> teachersById;
+    std::unordered_map<std::string, std::shared_ptr<Section>> sectionsById;
+    std::unordered_map<std::string, std::shared_ptr<Room>> roomsById;
+    std::unordered_set<const void*> added;  // every entity already in one of the lists
     
     // The current generated schedule
     std::shared_ptr<Schedule> currentSchedule;
     
-    // All possible schedules generated
-    std::vector<std::shared_ptr<Schedule>> possibleSchedules;
+    // All possible schedules generated, as section indices
+    SchedulePool schedulePool;
+    SolveStats lastSolveStats;
+    std::vector<StrategyStats> lastPortfolioStats;
     
     // PQ tree used for generating schedules
     PQTree pqTree;
     
+    // Random stream owned by this scheduler instance
+    Random random;
+    
+    // Requirements lowered to per-course section masks for fast checking
+    CompiledRequirements compiledRequirements;
+    
+    // Soft preferences folded into per-section scores
+    ScoreModel scoreModel;
+    
+    // Search over section equivalence classes
+    ScheduleSolver solver;
+    
+    // Scores how spread out a week is
+    CompactnessModel compactness;
+    
+    // Separate searches for groups of courses that cannot clash with each other
+    ComponentSolver componentSolver;
+    
+    // Counts and samples the schedules behind the solver's classes
+    ScheduleCounter counter;
+    
+    // Multi-objective search and the outcome of its last run
+    ParetoSolver paretoSolver;
+    ParetoResult lastParetoResult;
+    
+    // Best schedule over a subset of the courses
+    PartialSolver partialSolver;
+    PartialResult lastPartialResult;
+    
+    // Warm-start re-solves around pinned sections
+    ScheduleRepairer repairer;
+    RepairResult lastRepairResult;
+    
+    // Catalog sections by day for fit queries, rebuilt after sections change
+    CatalogIndex catalogIndex;
+    bool catalogIndexStale;
+    
+    // Teacher clashes and loads, checked as sections arrive
+    TeacherValidator teacherValidator;
+    bool teacherValidatorStale;
+    
     // Helper method to convert courses and sections to a PQ tree representation
     void buildPQTree();
     
     // Helper method to create actual schedules from the PQ tree layout
-    void extractSchedulesFromPQTree();
+    void extractSchedulesFromPQTree(const SolveOptions& options);
+    
+    // Helper method to race several strategies over the built solver
+    void runPortfolio(const SolveOptions& options, size_t capacity, const SearchLimits& limits,
+                      const std::vector<std::vector<int>>& rank);
+    
+    // Helper method to scale a search score the way SolveStats reports it
+    float normalizeObjective(float score) const;
+    
+    // Helper method to fill the solve stats from a search result
+    void recordSolveStats(const SearchResult& result);
+    
+    // Helper method to compile the current data and count the valid schedules
+    ScheduleCount buildCounter(size_t maxStates, double timeLimitSeconds);
     
     // Helper method to find a schedule that satisfies all requirements
     bool findSatisfyingSchedule();
+    
+    // Helper method to run the partial solver over the built solver
+    std::shared_ptr<Schedule> solvePartial(const PartialOptions& options);
+    
+    // Helper method to map a schedule to per-course section indices
+    std::vector<int> getChoiceForSchedule(const Schedule& schedule) const;
+    
+    // Helper method to build a schedule from per-course section indices
+    std::shared_ptr<Schedule> makeSchedule(const std::vector<int>& choice) const;
+    
+    // Helper method to read the section order of every course off the PQ tree leaves
+    std::vector<std::vector<int>> getSectionOrderFromPQTree() const;
 };
 
 #endif // SCHEDULER_HPP 
\ No newline at end of file
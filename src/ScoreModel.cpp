@@ -0,0 +1,99 @@
+#include "ScoreModel.hpp"
+#include <algorithm>
+
+ScoreModel::ScoreModel() : maxScore(0.0f), currentScore(0.0f) {}
+
+void ScoreModel::build(const std::vector<std::shared_ptr<Course>>& courses,
+                       const std::vector<std::shared_ptr<Preference>>& preferences) {
+    sectionScores.assign(courses.size(), std::vector<float>());
+    bestSectionScores.assign(courses.size(), 0.0f);
+    coursePreferences.assign(courses.size(), std::vector<size_t>());
+    maxScore = 0.0f;
+
+    std::unordered_map<const Course*, size_t> courseIndices;
+    for (size_t i = 0; i < courses.size(); ++i) {
+        courseIndices[courses[i].get()] = i;
+        sectionScores[i].assign(courses[i]->getSections().size(), 0.0f);
+    }
+
+    // Dependency index from course to the preferences that read it
+    for (size_t p = 0; p < preferences.size(); ++p) {
+        auto it = courseIndices.find(preferences[p]->getCourse().get());
+        if (it == courseIndices.end()) continue;
+        coursePreferences[it->second].push_back(p);
+        maxScore += preferences[p]->getWeight();
+    }
+
+    // Fold every preference into the per-section contribution table
+    for (size_t i = 0; i < courses.size(); ++i) {
+        const auto& sections = courses[i]->getSections();
+        for (size_t j = 0; j < sections.size(); ++j) {
+            float score = 0.0f;
+            for (size_t p : coursePreferences[i]) {
+                score += preferences[p]->scoreSection(*sections[j]);
+            }
+            sectionScores[i][j] = score;
+        }
+        if (!sectionScores[i].empty()) {
+            bestSectionScores[i] = *std::max_element(sectionScores[i].begin(), sectionScores[i].end());
+        }
+    }
+
+    currentChoice.assign(courses.size(), -1);
+    currentScore = 0.0f;
+}
+
+float ScoreModel::evaluate(const std::vector<int>& choice) const {
+    float score = 0.0f;
+    for (size_t i = 0; i < choice.size() && i < sectionScores.size(); ++i) {
+        score += getSectionScore(i, choice[i]);
+    }
+    return score;
+}
+
+float ScoreModel::getSectionScore(size_t courseIndex, int sectionIndex) const {
+    if (sectionIndex < 0 || static_cast<size_t>(sectionIndex) >= sectionScores[courseIndex].size()) {
+        return 0.0f;
+    }
+    return sectionScores[courseIndex][sectionIndex];
+}
+
+float ScoreModel::getBestSectionScore(size_t courseIndex) const {
+    return bestSectionScores[courseIndex];
+}
+
+float ScoreModel::getMaxScore() const {
+    return maxScore;
+}
+
+float ScoreModel::normalize(float score) const {
+    return maxScore > 0.0f ? (score / maxScore) : 1.0f;
+}
+
+const std::vector<size_t>& ScoreModel::getPreferencesForCourse(size_t courseIndex) const {
+    return coursePreferences[courseIndex];
+}
+
+void ScoreModel::reset(const std::vector<int>& choice) {
+    currentChoice = choice;
+    currentChoice.resize(sectionScores.size(), -1);
+    currentScore = evaluate(currentChoice);
+}
+
+float ScoreModel::getScore() const {
+    return currentScore;
+}
+
+float ScoreModel::delta(size_t courseIndex, int sectionIndex) const {
+    return getSectionScore(courseIndex, sectionIndex) -
+           getSectionScore(courseIndex, currentChoice[courseIndex]);
+}
+
+void ScoreModel::apply(size_t courseIndex, int sectionIndex) {
+    currentScore += delta(courseIndex, sectionIndex);
+    currentChoice[courseIndex] = sectionIndex;
+}
+
+const std::vector<int>& ScoreModel::getChoice() const {
+    return currentChoice;
+}
@@ -0,0 +1,56 @@
+#ifndef SCORE_MODEL_HPP
+#define SCORE_MODEL_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Scores schedules against weighted soft preferences.
+// build() folds every preference into a per-section score table, so the
+// score of a choice vector is one lookup per course and swapping the section
+// of one course is an O(1) delta. Course and section indices follow the same
+// numbering as CompiledRequirements.
+class ScoreModel {
+public:
+    ScoreModel();
+
+    void build(const std::vector<std::shared_ptr<Course>>& courses,
+               const std::vector<std::shared_ptr<Preference>>& preferences);
+
+    // Full evaluation, choice[i] is the section index for course i or -1
+    float evaluate(const std::vector<int>& choice) const;
+
+    // Score of a single (course, section) pick, 0 for -1
+    float getSectionScore(size_t courseIndex, int sectionIndex) const;
+
+    // Best score any section of the course can earn, used as an optimistic bound
+    float getBestSectionScore(size_t courseIndex) const;
+
+    // Sum of all preference weights, the score of a schedule meeting every preference
+    float getMaxScore() const;
+
+    // Score scaled to [0, 1] the same way the old evaluateSchedule() reported it
+    float normalize(float score) const;
+
+    // Preferences that mention the course, indices into the list passed to build()
+    const std::vector<size_t>& getPreferencesForCourse(size_t courseIndex) const;
+
+    // Incremental evaluation around a current choice
+    void reset(const std::vector<int>& choice);
+    float getScore() const;
+    float delta(size_t courseIndex, int sectionIndex) const;
+    void apply(size_t courseIndex, int sectionIndex);
+    const std::vector<int>& getChoice() const;
+
+private:
+    std::vector<std::vector<float>> sectionScores;
+    std::vector<float> bestSectionScores;
+    std::vector<std::vector<size_t>> coursePreferences;
+    float maxScore;
+
+    std::vector<int> currentChoice;
+    float currentScore;
+};
+
+#endif // SCORE_MODEL_HPP
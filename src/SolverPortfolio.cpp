@@ -0,0 +1,349 @@
+#include "SolverPortfolio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+uint64_t fingerprintOf(const std::vector<int>& choice) {
+    uint64_t fingerprint = 0xcbf29ce484222325ULL;
+    for (int section : choice) {
+        fingerprint = (fingerprint ^ static_cast<uint64_t>(static_cast<uint32_t>(section))) * 0x100000001b3ULL;
+    }
+    return fingerprint;
+}
+
+// Higher score first, then the smaller section indices from the last course back
+bool ranksAhead(float scoreA, const std::vector<int>& a, float scoreB, const std::vector<int>& b) {
+    if (scoreA != scoreB) return scoreA > scoreB;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i];
+    }
+    return false;
+}
+
+}
+
+SolverPortfolio::SolverPortfolio()
+    : capacity(1), cancel(false), incumbent(-std::numeric_limits<float>::infinity()), firstProof(-1) {}
+
+void SolverPortfolio::addBranchAndBound(const std::string& name, const std::vector<std::vector<int>>& rank) {
+    strategies.push_back(Strategy{name, false, rank, 0});
+}
+
+void SolverPortfolio::addLocalSearch(const std::string& name, uint64_t seed) {
+    strategies.push_back(Strategy{name, true, std::vector<std::vector<int>>(), seed});
+}
+
+SearchResult SolverPortfolio::run(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                                  size_t keep, const SearchLimits& limits) {
+    auto startTime = std::chrono::steady_clock::now();
+    kept.assign(strategies.size(), Kept());
+    sharedBest.clear();
+    sharedMembers.clear();
+    capacity = std::max<size_t>(1, keep);
+    cancel.store(false);
+    incumbent.store(-std::numeric_limits<float>::infinity());
+    firstProof = -1;
+
+    stats.assign(strategies.size(), StrategyStats());
+    std::vector<SearchResult> results(strategies.size());
+
+    SearchLimits shared = limits;
+    shared.cancel = &cancel;
+    shared.incumbent = &incumbent;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        stats[i].name = strategies[i].name;
+        workers.emplace_back([this, &solver, compactness, &shared, &results, i]() {
+            if (strategies[i].localSearch) {
+                runLocalSearch(solver, compactness, shared, static_cast<int>(i));
+            } else {
+                runBranchAndBound(solver, compactness, shared, static_cast<int>(i), results[i]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Best first, so the first kept schedule is the best found
+    int bestFinder = -1;
+    merge(bestFinder);
+
+    SearchResult result;
+    result.solutions = solutions.size();
+    if (!scores.empty()) result.bestScore = scores.front();
+
+    // Without a proof, the tightest bound any unfinished branch and bound left behind
+    float bound = solver.getRootBound();
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        result.nodes += stats[i].nodes;
+        if (!strategies[i].localSearch) bound = std::min(bound, results[i].bound);
+    }
+
+    result.completed = firstProof >= 0;
+    result.bound = result.completed ? result.bestScore : std::max(result.bestScore, bound);
+
+    if (firstProof >= 0) {
+        stats[firstProof].won = true;
+    } else if (bestFinder >= 0) {
+        stats[bestFinder].won = true;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+const std::vector<std::vector<int>>& SolverPortfolio::getSolutions() const {
+    return solutions;
+}
+
+const std::vector<float>& SolverPortfolio::getScores() const {
+    return scores;
+}
+
+const std::vector<StrategyStats>& SolverPortfolio::getStats() const {
+    return stats;
+}
+
+void SolverPortfolio::offer(const std::vector<int>& choice, float score, int strategy) {
+    uint64_t fingerprint = fingerprintOf(choice);
+
+    // The strategy's own list needs no lock; only its thread touches it. Local
+    // search restarts often climb back to a schedule they already have.
+    Kept& own = kept[strategy];
+    for (size_t slot = 0; slot < own.solutions.size(); ++slot) {
+        if (own.fingerprints[slot] == fingerprint && own.solutions[slot] == choice) return;
+    }
+    auto worstFirst = [&own](size_t a, size_t b) {
+        return ranksAhead(own.scores[a], own.solutions[a], own.scores[b], own.solutions[b]);
+    };
+    if (own.solutions.size() < capacity) {
+        own.solutions.push_back(choice);
+        own.scores.push_back(score);
+        own.fingerprints.push_back(fingerprint);
+        own.worst.push_back(own.solutions.size() - 1);
+        std::push_heap(own.worst.begin(), own.worst.end(), worstFirst);
+    } else if (ranksAhead(score, choice, own.scores[own.worst.front()], own.solutions[own.worst.front()])) {
+        std::pop_heap(own.worst.begin(), own.worst.end(), worstFirst);
+        size_t slot = own.worst.back();
+        own.solutions[slot] = choice;
+        own.scores[slot] = score;
+        own.fingerprints[slot] = fingerprint;
+        std::push_heap(own.worst.begin(), own.worst.end(), worstFirst);
+    } else {
+        return;
+    }
+
+    // Strategies often meet at the same schedule; count it once
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sharedMembers.count(fingerprint)) return;
+    if (sharedBest.size() == capacity) {
+        if (score <= sharedBest.begin()->first) return;
+        sharedMembers.erase(sharedBest.begin()->second);
+        sharedBest.erase(sharedBest.begin());
+    }
+    sharedBest.insert(std::make_pair(score, fingerprint));
+    sharedMembers.insert(fingerprint);
+
+    // With keep schedules known, only subtrees that beat the worst of them can change the result
+    if (sharedBest.size() == capacity) {
+        float threshold = sharedBest.begin()->first;
+        if (threshold > incumbent.load()) incumbent.store(threshold);
+    }
+}
+
+void SolverPortfolio::merge(int& bestFinder) {
+    struct Entry {
+        float score;
+        uint64_t fingerprint;
+        int strategy;
+        size_t slot;
+    };
+    // After a proof the prover alone has seen everything that belongs in the result
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < kept.size(); ++i) {
+        if (firstProof >= 0 && static_cast<int>(i) != firstProof) continue;
+        for (size_t slot = 0; slot < kept[i].solutions.size(); ++slot) {
+            entries.push_back(Entry{kept[i].scores[slot], kept[i].fingerprints[slot], static_cast<int>(i), slot});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+        const std::vector<int>& choiceA = kept[a.strategy].solutions[a.slot];
+        const std::vector<int>& choiceB = kept[b.strategy].solutions[b.slot];
+        if (ranksAhead(a.score, choiceA, b.score, choiceB)) return true;
+        if (ranksAhead(b.score, choiceB, a.score, choiceA)) return false;
+        return a.strategy < b.strategy;
+    });
+
+    solutions.clear();
+    scores.clear();
+    bestFinder = -1;
+
+    // A schedule found by several strategies is kept once, at its first place in that order
+    std::unordered_multimap<uint64_t, size_t> taken;
+    for (size_t e = 0; e < entries.size() && solutions.size() < capacity; ++e) {
+        const std::vector<int>& choice = kept[entries[e].strategy].solutions[entries[e].slot];
+        auto range = taken.equal_range(entries[e].fingerprint);
+        bool duplicate = false;
+        for (auto it = range.first; it != range.second && !duplicate; ++it) {
+            duplicate = solutions[it->second] == choice;
+        }
+        if (duplicate) continue;
+
+        if (solutions.empty()) bestFinder = entries[e].strategy;
+        taken.emplace(entries[e].fingerprint, solutions.size());
+        solutions.push_back(choice);
+        scores.push_back(entries[e].score);
+    }
+}
+
+void SolverPortfolio::runBranchAndBound(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                                        const SearchLimits& limits, int strategy, SearchResult& result) {
+    // Sorted members make every strategy expand a class assignment into the same
+    // schedules, and keeping ties lets whichever proves first stand for all of them
+    ScheduleSolver local = solver;
+    if (!strategies[strategy].rank.empty()) {
+        local.setSectionOrder(strategies[strategy].rank);
+    }
+    local.sortMembers();
+    local.setKeepTies(true);
+    local.setCompactness(compactness);
+
+    StrategyStats& own = stats[strategy];
+    std::vector<std::vector<int>> expanded;
+    result = local.search([&](const std::vector<int>& classChoice, float score) {
+        // Every combination of equivalent sections is a schedule of its own
+        expanded.clear();
+        local.expand(classChoice, capacity, expanded);
+        for (const auto& choice : expanded) offer(choice, score, strategy);
+        own.solutions++;
+
+        float shared = incumbent.load();
+        if (shared > -std::numeric_limits<float>::infinity()) {
+            local.setPruneThreshold(shared);
+        }
+        return !cancel.load();
+    }, limits);
+
+    own.nodes = result.nodes;
+    own.bestScore = result.bestScore;
+    own.seconds = result.seconds;
+
+    if (result.completed) {
+        own.proved = true;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (firstProof < 0) {
+            firstProof = strategy;
+            cancel.store(true);
+        }
+    }
+}
+
+void SolverPortfolio::runLocalSearch(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                                     const SearchLimits& limits, int strategy) {
+    auto startTime = std::chrono::steady_clock::now();
+    StrategyStats& own = stats[strategy];
+    Random random(strategies[strategy].seed);
+    bool compact = compactness && compactness->isActive();
+
+    size_t courseCount = solver.getCourseCount();
+    // Scores are added up in branching order, so a schedule scores to the same bits as in branch and bound
+    std::vector<int> courses;
+    for (int course : solver.getCourseOrder()) {
+        if (!solver.getClasses(course).empty()) courses.push_back(course);
+    }
+
+    auto fits = [&](const std::vector<int>& choice, int course, int k) {
+        const MeetingPattern& pattern = *solver.getClasses(course)[k].pattern;
+        for (int other : courses) {
+            if (other == course || choice[other] < 0) continue;
+            if (pattern.overlaps(*solver.getClasses(other)[choice[other]].pattern)) return false;
+        }
+        return true;
+    };
+    auto evaluate = [&](const std::vector<int>& choice) {
+        float score = 0.0f;
+        uint64_t days[CompactnessModel::DAYS] = {0, 0, 0, 0, 0};
+        for (int course : courses) {
+            const SectionClass& sectionClass = solver.getClasses(course)[choice[course]];
+            score += sectionClass.score;
+            CompactnessModel::addToWeek(*sectionClass.pattern, days);
+        }
+        return compact ? score - compactness->penalty(days) : score;
+    };
+    auto outOfBudget = [&]() {
+        if (cancel.load()) return true;
+        if (limits.nodeLimit > 0 && own.nodes >= limits.nodeLimit) return true;
+        if (limits.timeLimitSeconds > 0.0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >
+                limits.timeLimitSeconds) {
+            return true;
+        }
+        return false;
+    };
+
+    // Without a time limit nothing else would stop it, so restarts are capped
+    const size_t maxRestarts = limits.timeLimitSeconds > 0.0 ? std::numeric_limits<size_t>::max() : 1000;
+
+    std::vector<int> choice(courseCount, -1);
+    std::vector<std::vector<int>> expanded;
+    for (size_t restart = 0; restart < maxRestarts && !solver.isInfeasible() && !outOfBudget(); ++restart) {
+        // Randomized greedy start: courses in random order, each takes its best fitting class
+        std::fill(choice.begin(), choice.end(), -1);
+        std::vector<int> order = courses;
+        random.shuffle(order);
+        bool placed = true;
+        for (int course : order) {
+            int best = -1;
+            const auto& classes = solver.getClasses(course);
+            size_t offset = random.nextIndex(classes.size());
+            for (size_t n = 0; n < classes.size(); ++n) {
+                int k = static_cast<int>((offset + n) % classes.size());
+                if (fits(choice, course, k) && (best < 0 || classes[k].score > classes[best].score)) best = k;
+            }
+            own.nodes++;
+            if (best < 0) {
+                placed = false;
+                break;
+            }
+            choice[course] = best;
+        }
+        if (!placed) continue;
+
+        // Hill climb: move single courses to better fitting classes until nothing improves
+        float score = evaluate(choice);
+        bool improved = true;
+        while (improved && !outOfBudget()) {
+            improved = false;
+            for (int course : courses) {
+                int current = choice[course];
+                for (size_t k = 0; k < solver.getClasses(course).size(); ++k) {
+                    if (static_cast<int>(k) == current || !fits(choice, course, static_cast<int>(k))) continue;
+                    choice[course] = static_cast<int>(k);
+                    float candidate = evaluate(choice);
+                    own.nodes++;
+                    if (candidate > score + 1e-6f) {
+                        score = candidate;
+                        current = static_cast<int>(k);
+                        improved = true;
+                    }
+                    choice[course] = current;
+                }
+            }
+        }
+
+        if (own.solutions == 0 || score > own.bestScore) own.bestScore = score;
+        own.solutions++;
+        expanded.clear();
+        solver.expand(choice, capacity, expanded);
+        for (const auto& sections : expanded) offer(sections, score, strategy);
+    }
+
+    own.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
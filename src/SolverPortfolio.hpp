@@ -0,0 +1,101 @@
+#ifndef SOLVER_PORTFOLIO_HPP
+#define SOLVER_PORTFOLIO_HPP
+
+#include "ScheduleSolver.hpp"
+#include "CompactnessModel.hpp"
+#include "Random.hpp"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// What one strategy of a portfolio run did
+struct StrategyStats {
+    std::string name;
+    size_t nodes = 0;        // search nodes, or local search moves
+    size_t solutions = 0;
+    float bestScore = 0.0f;  // raw solver score, 0 if it found nothing
+    bool proved = false;     // finished its search, proving the incumbent optimal
+    bool won = false;        // proved first, or found the best schedule by the deadline
+    double seconds = 0.0;
+};
+
+// Runs several search strategies on their own threads over copies of one
+// built ScheduleSolver. Each strategy keeps its own best schedules; they
+// share only the keep-th best score over all of them, published as soon as
+// that many distinct schedules exist, as an incumbent every branch and bound
+// prunes against. The first branch and bound to finish proves the kept
+// scores optimal and cancels the rest; otherwise everything stops at the
+// time limit. Local search never proves anything but often finds a strong
+// incumbent early.
+// Schedules rank by score, then by their section indices read from the last
+// course back, which is the order expand() lists the schedules of a class
+// assignment in once the members are sorted. Branch and bound keeps every
+// subtree that can tie the incumbent, so the one that proves has seen every
+// schedule that belongs in the result, and after a proof the result is its
+// list alone: the same keep schedules in the same order on every run, whoever
+// proves first. Many schedules sharing a score make that proof slower. Only a
+// run cut short by a limit depends on thread timing; it merges every
+// strategy's list in rank order, then strategy index.
+class SolverPortfolio {
+public:
+    SolverPortfolio();
+
+    // Value orders as for ScheduleSolver::setSectionOrder()
+    void addBranchAndBound(const std::string& name, const std::vector<std::vector<int>>& rank);
+    void addLocalSearch(const std::string& name, uint64_t seed);
+
+    // Keeps the keep best schedules found by any strategy
+    SearchResult run(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                     size_t keep, const SearchLimits& limits);
+
+    // Kept schedules as per-course section indices with their scores, best first
+    const std::vector<std::vector<int>>& getSolutions() const;
+    const std::vector<float>& getScores() const;
+
+    const std::vector<StrategyStats>& getStats() const;
+
+private:
+    struct Strategy {
+        std::string name;
+        bool localSearch;
+        std::vector<std::vector<int>> rank;
+        uint64_t seed;
+    };
+
+    // A strategy's own best schedules, with a heap over slots keeping the lowest ranked on top
+    struct Kept {
+        std::vector<std::vector<int>> solutions;
+        std::vector<float> scores;
+        std::vector<uint64_t> fingerprints;
+        std::vector<size_t> worst;
+    };
+
+    std::vector<Strategy> strategies;
+    std::vector<StrategyStats> stats;
+    std::vector<Kept> kept;
+
+    // Merged result
+    std::vector<std::vector<int>> solutions;
+    std::vector<float> scores;
+
+    // Shared between the worker threads: the best distinct scores by fingerprint, for the incumbent
+    std::mutex mutex;
+    std::set<std::pair<float, uint64_t>> sharedBest;
+    std::unordered_set<uint64_t> sharedMembers;
+    size_t capacity;
+    std::atomic<bool> cancel;
+    std::atomic<float> incumbent;
+    int firstProof;
+
+    void offer(const std::vector<int>& choice, float score, int strategy);
+    void merge(int& bestFinder);
+    void runBranchAndBound(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                           const SearchLimits& limits, int strategy, SearchResult& result);
+    void runLocalSearch(const ScheduleSolver& solver, const CompactnessModel* compactness,
+                        const SearchLimits& limits, int strategy);
+};
+
+#endif // SOLVER_PORTFOLIO_HPP
@@ -0,0 +1,266 @@
+#include "TeacherAssigner.hpp"
+#include "BipartiteMatching.hpp"
+#include "MinCostFlow.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <map>
+
+namespace {
+
+// Keeping a section's teacher outweighs any difference in load
+const int64_t CHANGE_COST = int64_t(1) << 20;
+
+bool clashes(const std::shared_ptr<MeetingPattern>& pattern,
+             const std::vector<std::shared_ptr<MeetingPattern>>& booked) {
+    if (!pattern) return false;
+    for (const auto& other : booked) {
+        if (pattern->overlaps(*other)) return true;
+    }
+    return false;
+}
+
+}
+
+TeacherAssigner::TeacherAssigner(const TeacherAssignmentOptions& options) : options(options) {}
+
+void TeacherAssigner::addTeacher(std::shared_ptr<Teacher> teacher) {
+    teachers.push_back(teacher);
+}
+
+void TeacherAssigner::addSection(std::shared_ptr<Section> section) {
+    sections.push_back(section);
+}
+
+void TeacherAssigner::addRequirement(std::shared_ptr<Requirement> requirement) {
+    auto teacherRequirement = std::dynamic_pointer_cast<TeacherRequirement>(requirement);
+    if (teacherRequirement && teacherRequirement->getCourse() && teacherRequirement->getTeacher()) {
+        requiredTeachers[teacherRequirement->getCourse()->getCode()].push_back(
+            teacherRequirement->getTeacher()->getId());
+    }
+}
+
+TeacherAssignmentResult TeacherAssigner::run() {
+    TeacherAssignmentResult result;
+    auto startTime = std::chrono::steady_clock::now();
+    unassigned.clear();
+
+    // Every teacher once, including ones only known through their sections
+    std::vector<std::shared_ptr<Teacher>> pool;
+    std::unordered_map<const Teacher*, int> index;
+    auto indexOf = [&pool, &index](const std::shared_ptr<Teacher>& teacher) {
+        auto inserted = index.emplace(teacher.get(), static_cast<int>(pool.size()));
+        if (inserted.second) pool.push_back(teacher);
+        return inserted.first->second;
+    };
+    for (const auto& teacher : teachers) {
+        if (teacher) indexOf(teacher);
+    }
+    std::vector<int> previous(sections.size(), -1);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i]->getTeacher()) previous[i] = indexOf(sections[i]->getTeacher());
+    }
+
+    std::unordered_map<std::string, std::vector<int>> qualified;
+    for (size_t t = 0; t < pool.size(); ++t) {
+        for (const auto& course : pool[t]->getCourses()) {
+            qualified[course->getCode()].push_back(static_cast<int>(t));
+        }
+    }
+
+    // Requirements decide who may teach a course; without any, the teachers' own course lists do
+    std::unordered_map<std::string, std::vector<int>> eligible;
+    auto eligibleFor = [&](const Course& course) -> const std::vector<int>& {
+        auto it = eligible.find(course.getCode());
+        if (it != eligible.end()) return it->second;
+
+        std::vector<int>& list = eligible[course.getCode()];
+        if (requiredTeachers.count(course.getCode())) {
+            for (size_t t = 0; t < pool.size(); ++t) {
+                if (isAllowed(*pool[t], course)) list.push_back(static_cast<int>(t));
+            }
+        } else {
+            auto found = qualified.find(course.getCode());
+            if (found != qualified.end()) list = found->second;
+        }
+        return list;
+    };
+
+    // Sections that keep their teacher are fixed bookings the others must avoid
+    std::vector<int> open;
+    std::vector<std::vector<std::shared_ptr<MeetingPattern>>> booked(pool.size());
+    std::vector<int> load(pool.size(), 0);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        auto teacher = sections[i]->getTeacher();
+        if (!options.reassignAll && teacher && isAllowed(*teacher, *sections[i]->getCourse())) {
+            load[previous[i]]++;
+            if (sections[i]->getMeetingPattern()) booked[previous[i]].push_back(sections[i]->getMeetingPattern());
+        } else {
+            open.push_back(static_cast<int>(i));
+        }
+    }
+    int limit = options.maxSectionsPerTeacher > 0 ? options.maxSectionsPerTeacher : INT_MAX;
+
+    // Open sections meeting at exactly the same times share a block; untimed ones never clash
+    std::map<std::vector<uint32_t>, int> blockByMeetings;
+    std::vector<int> blockOf(open.size());
+    int blockCount = 0;
+    for (size_t k = 0; k < open.size(); ++k) {
+        auto pattern = sections[open[k]]->getMeetingPattern();
+        if (!pattern || pattern->isEmpty()) {
+            blockOf[k] = blockCount++;
+            continue;
+        }
+        std::vector<uint32_t> key;
+        for (PackedTimeSlot meeting : pattern->getMeetings()) key.push_back(meeting.raw());
+        std::sort(key.begin(), key.end());
+        auto inserted = blockByMeetings.emplace(key, blockCount);
+        if (inserted.second) blockCount++;
+        blockOf[k] = inserted.first->second;
+    }
+
+    // Slots are created on first use; -1 marks a block clashing with the teacher's fixed sections
+    std::vector<Slot> slots;
+    std::unordered_map<int64_t, int> slotIndex;
+    std::vector<std::vector<int>> slotsOf(open.size());
+    for (size_t k = 0; k < open.size(); ++k) {
+        const auto& section = sections[open[k]];
+        for (int t : eligibleFor(*section->getCourse())) {
+            if (load[t] >= limit) continue;
+
+            int64_t key = static_cast<int64_t>(blockOf[k]) * static_cast<int64_t>(pool.size()) + t;
+            auto it = slotIndex.find(key);
+            if (it == slotIndex.end()) {
+                int id = clashes(section->getMeetingPattern(), booked[t]) ? -1 : static_cast<int>(slots.size());
+                it = slotIndex.emplace(key, id).first;
+                if (id >= 0) slots.push_back(Slot{t, blockOf[k]});
+            }
+            if (it->second >= 0) slotsOf[k].push_back(it->second);
+        }
+    }
+
+    std::vector<int> teacherOf(open.size(), -1);
+    result.usedFlow = options.reassignAll || options.balanceLoad || options.maxSectionsPerTeacher > 0;
+    if (!result.usedFlow) {
+        BipartiteMatching matching;
+        matching.reset(static_cast<int>(open.size()), static_cast<int>(slots.size()));
+        for (size_t k = 0; k < open.size(); ++k) {
+            for (int slot : slotsOf[k]) matching.addEdge(static_cast<int>(k), slot);
+        }
+        matching.solve();
+        for (size_t k = 0; k < open.size(); ++k) {
+            int slot = matching.getMatch(static_cast<int>(k));
+            if (slot >= 0) teacherOf[k] = slots[slot].teacher;
+        }
+    } else {
+        // source -> section -> (teacher, block) -> teacher -> sink; a maximum
+        // flow of least cost first keeps teachers, then evens out the loads
+        int source = 0;
+        int sink = 1;
+        int sectionBase = 2;
+        int slotBase = sectionBase + static_cast<int>(open.size());
+        int teacherBase = slotBase + static_cast<int>(slots.size());
+        MinCostFlow flow(teacherBase + static_cast<int>(pool.size()));
+
+        std::vector<std::vector<int>> edgesOf(open.size());
+        for (size_t k = 0; k < open.size(); ++k) {
+            flow.addEdge(source, sectionBase + static_cast<int>(k), 1, 0);
+            for (int slot : slotsOf[k]) {
+                int before = previous[open[k]];
+                int64_t cost = before >= 0 && slots[slot].teacher != before ? CHANGE_COST : 0;
+                edgesOf[k].push_back(flow.addEdge(sectionBase + static_cast<int>(k), slotBase + slot, 1, cost));
+            }
+        }
+
+        std::vector<int> slotCount(pool.size(), 0);
+        for (size_t s = 0; s < slots.size(); ++s) {
+            flow.addEdge(slotBase + static_cast<int>(s), teacherBase + slots[s].teacher, 1, 0);
+            slotCount[slots[s].teacher]++;
+        }
+
+        // Rising costs per extra section make the cheapest flow the most even one
+        for (size_t t = 0; t < pool.size(); ++t) {
+            int room = std::min(limit - load[t], slotCount[t]);
+            if (room <= 0) continue;
+            if (options.balanceLoad) {
+                for (int extra = 1; extra <= room; ++extra) {
+                    flow.addEdge(teacherBase + static_cast<int>(t), sink, 1, load[t] + extra);
+                }
+            } else {
+                flow.addEdge(teacherBase + static_cast<int>(t), sink, room, 0);
+            }
+        }
+        flow.solve(source, sink);
+
+        for (size_t k = 0; k < open.size(); ++k) {
+            for (size_t j = 0; j < edgesOf[k].size(); ++j) {
+                if (flow.getFlow(edgesOf[k][j]) > 0) teacherOf[k] = slots[slotsOf[k][j]].teacher;
+            }
+        }
+    }
+
+    // Blocks that overlap without being equal may still double book a teacher; the first section stays
+    for (size_t k = 0; k < open.size(); ++k) {
+        int t = teacherOf[k];
+        if (t < 0) continue;
+        auto pattern = sections[open[k]]->getMeetingPattern();
+        if (clashes(pattern, booked[t])) {
+            teacherOf[k] = -1;
+            continue;
+        }
+        if (pattern) booked[t].push_back(pattern);
+        load[t]++;
+    }
+
+    // Sections left over take the least loaded qualified teacher still free, their own first
+    for (size_t k = 0; k < open.size(); ++k) {
+        if (teacherOf[k] >= 0) continue;
+        const auto& section = sections[open[k]];
+        int best = -1;
+        for (int t : eligibleFor(*section->getCourse())) {
+            if (load[t] >= limit || clashes(section->getMeetingPattern(), booked[t])) continue;
+            if (t == previous[open[k]]) {
+                best = t;
+                break;
+            }
+            if (best < 0 || load[t] < load[best]) best = t;
+        }
+        if (best < 0) continue;
+
+        teacherOf[k] = best;
+        if (section->getMeetingPattern()) booked[best].push_back(section->getMeetingPattern());
+        load[best]++;
+    }
+
+    for (size_t k = 0; k < open.size(); ++k) {
+        const auto& section = sections[open[k]];
+        if (teacherOf[k] != previous[open[k]]) result.changed++;
+        if (teacherOf[k] >= 0) {
+            pool[teacherOf[k]]->addCourse(section->getCourse());
+            section->setTeacher(pool[teacherOf[k]]);
+            result.assigned++;
+        } else {
+            section->setTeacher(nullptr);
+            unassigned.push_back(section);
+        }
+    }
+
+    result.open = open.size();
+    result.unassigned = unassigned.size();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+const std::vector<std::shared_ptr<Section>>& TeacherAssigner::getUnassigned() const {
+    return unassigned;
+}
+
+bool TeacherAssigner::isAllowed(const Teacher& teacher, const Course& course) const {
+    auto it = requiredTeachers.find(course.getCode());
+    if (it == requiredTeachers.end()) return true;
+    for (const auto& id : it->second) {
+        if (id != teacher.getId()) return false;
+    }
+    return true;
+}
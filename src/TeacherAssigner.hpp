@@ -0,0 +1,67 @@
+#ifndef TEACHER_ASSIGNER_HPP
+#define TEACHER_ASSIGNER_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct TeacherAssignmentOptions {
+    bool reassignAll = false;       // also move sections whose teacher is already valid
+    bool balanceLoad = false;       // spread sections evenly over the qualified teachers
+    int maxSectionsPerTeacher = 0;  // zero means no limit
+};
+
+struct TeacherAssignmentResult {
+    size_t open = 0;        // sections that needed a teacher
+    size_t assigned = 0;
+    size_t unassigned = 0;  // no qualified teacher free at the section's times
+    size_t changed = 0;     // sections whose teacher differs from before
+    bool usedFlow = false;  // loads or changes were weighed by min-cost flow
+    double seconds = 0.0;
+};
+
+// Gives teachers to sections that have none, or whose teacher breaks a
+// TeacherRequirement of the course. A teacher qualifies through the course's
+// TeacherRequirements, or else through Teacher::getCourses().
+// Open sections with the same meetings form a time block, and each teacher
+// can take one section per block, so covering the sections is a bipartite
+// matching from sections to (teacher, block) pairs, solved by Hopcroft-Karp
+// in O(E sqrt(V)). Pairs that clash with a teacher's fixed sections are left
+// out. Load limits, balancing and keeping current teachers need costs, so
+// those runs use a min-cost flow through the teachers instead. Blocks that
+// overlap without being equal can still double book a teacher; a final pass
+// drops those sections and gives them any qualified teacher still free.
+class TeacherAssigner {
+public:
+    explicit TeacherAssigner(const TeacherAssignmentOptions& options = TeacherAssignmentOptions());
+
+    void addTeacher(std::shared_ptr<Teacher> teacher);
+    void addSection(std::shared_ptr<Section> section);
+    void addRequirement(std::shared_ptr<Requirement> requirement);
+
+    // Assigns teachers and writes them to the sections
+    TeacherAssignmentResult run();
+
+    const std::vector<std::shared_ptr<Section>>& getUnassigned() const;
+
+private:
+    // A (teacher, block) pair a section can be matched to
+    struct Slot {
+        int teacher;
+        int block;
+    };
+
+    TeacherAssignmentOptions options;
+    std::vector<std::shared_ptr<Teacher>> teachers;
+    std::vector<std::shared_ptr<Section>> sections;
+    std::vector<std::shared_ptr<Section>> unassigned;
+
+    // Teacher ids every section of a course must have, by course code
+    std::unordered_map<std::string, std::vector<std::string>> requiredTeachers;
+
+    bool isAllowed(const Teacher& teacher, const Course& course) const;
+};
+
+#endif // TEACHER_ASSIGNER_HPP
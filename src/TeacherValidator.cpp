@@ -0,0 +1,197 @@
+#include "TeacherValidator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+TeacherValidator::TeacherValidator(const TeacherLoadLimits& limits) : limits(limits) {}
+
+void TeacherValidator::setLimits(const TeacherLoadLimits& limits) {
+    this->limits = limits;
+}
+
+const TeacherLoadLimits& TeacherValidator::getLimits() const {
+    return limits;
+}
+
+void TeacherValidator::clear() {
+    sections.clear();
+    states.clear();
+    stateByTeacher.clear();
+}
+
+void TeacherValidator::addSection(std::shared_ptr<Section> section) {
+    int index = static_cast<int>(sections.size());
+    sections.push_back(section);
+    if (section->getTeacher()) {
+        insert(stateFor(section->getTeacher()), index);
+    }
+}
+
+void TeacherValidator::recheckAll(size_t threads) {
+    // Teachers may have changed hands since the sections were added
+    for (auto& state : states) {
+        state.sections.clear();
+    }
+    for (size_t s = 0; s < sections.size(); ++s) {
+        if (sections[s]->getTeacher()) {
+            stateFor(sections[s]->getTeacher()).sections.push_back(static_cast<int>(s));
+        }
+    }
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, states.size());
+
+    // Teachers are independent, so workers just take the next one in line
+    std::atomic<size_t> next(0);
+    auto work = [this, &next]() {
+        for (size_t t = next++; t < states.size(); t = next++) {
+            sweep(states[t]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+TeacherValidation TeacherValidator::getValidation() const {
+    TeacherValidation validation;
+    validation.teachers = states.size();
+    validation.sections = sections.size();
+
+    std::vector<std::pair<int, int>> pairs;
+    for (const auto& state : states) {
+        pairs.insert(pairs.end(), state.conflicts.begin(), state.conflicts.end());
+
+        if (limits.maxWeeklyMinutes > 0 && state.weekMinutes > limits.maxWeeklyMinutes) {
+            validation.loadViolations.push_back(LoadViolation{state.teacher, -1, state.weekMinutes,
+                                                              limits.maxWeeklyMinutes});
+        }
+        for (int day = 0; day < MeetingPattern::DAYS; ++day) {
+            if (limits.maxDailyMinutes > 0 && state.dayMinutes[day] > limits.maxDailyMinutes) {
+                validation.loadViolations.push_back(LoadViolation{state.teacher, day, state.dayMinutes[day],
+                                                                  limits.maxDailyMinutes});
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+    for (const auto& pair : pairs) {
+        const auto& second = sections[pair.second];
+        validation.doubleBookings.push_back(DoubleBooking{second->getTeacher(), sections[pair.first], second});
+    }
+    return validation;
+}
+
+TeacherValidator::TeacherState& TeacherValidator::stateFor(std::shared_ptr<Teacher> teacher) {
+    auto it = stateByTeacher.find(teacher.get());
+    if (it != stateByTeacher.end()) {
+        return states[it->second];
+    }
+
+    stateByTeacher.emplace(teacher.get(), states.size());
+    states.push_back(TeacherState());
+    states.back().teacher = teacher;
+    resetBookings(states.back());
+    return states.back();
+}
+
+void TeacherValidator::insert(TeacherState& state, int section) {
+    state.sections.push_back(section);
+    auto pattern = sections[section]->getMeetingPattern();
+    if (!pattern) return;
+
+    // Earlier sections this one clashes with, once each however many days they share
+    std::vector<int> clashes;
+    for (PackedTimeSlot meeting : pattern->getMeetings()) {
+        int day = meeting.getDay();
+        int start = meeting.getStartMinute();
+        int end = meeting.getEndMinute();
+        std::vector<Booking>& bookings = state.days[day];
+
+        auto position = std::upper_bound(bookings.begin(), bookings.end(), start,
+                                         [](int value, const Booking& booking) { return value < booking.start; });
+        // Bookings starting later overlap until one starts after this ends
+        for (auto it = position; it != bookings.end() && it->start < end; ++it) {
+            if (it->section != section) clashes.push_back(it->section);
+        }
+        // Earlier starts can only reach this one if they began within the longest booking
+        for (auto it = position; it != bookings.begin();) {
+            --it;
+            if (it->start < start - state.longest[day]) break;
+            if (it->end > start && it->start < end && it->section != section) clashes.push_back(it->section);
+        }
+
+        bookings.insert(position, Booking{start, end, section});
+        state.longest[day] = std::max(state.longest[day], end - start);
+        state.dayMinutes[day] += end - start;
+        state.weekMinutes += end - start;
+    }
+
+    std::sort(clashes.begin(), clashes.end());
+    clashes.erase(std::unique(clashes.begin(), clashes.end()), clashes.end());
+    for (int other : clashes) {
+        state.conflicts.push_back(std::make_pair(other, section));
+    }
+}
+
+void TeacherValidator::resetBookings(TeacherState& state) {
+    for (int day = 0; day < MeetingPattern::DAYS; ++day) {
+        state.days[day].clear();
+        state.longest[day] = 0;
+        state.dayMinutes[day] = 0;
+    }
+    state.weekMinutes = 0;
+    state.conflicts.clear();
+}
+
+void TeacherValidator::sweep(TeacherState& state) const {
+    resetBookings(state);
+    for (int section : state.sections) {
+        auto pattern = sections[section]->getMeetingPattern();
+        if (!pattern) continue;
+        for (PackedTimeSlot meeting : pattern->getMeetings()) {
+            int day = meeting.getDay();
+            int minutes = meeting.getDurationMinutes();
+            state.days[day].push_back(Booking{meeting.getStartMinute(), meeting.getEndMinute(), section});
+            state.longest[day] = std::max(state.longest[day], minutes);
+            state.dayMinutes[day] += minutes;
+            state.weekMinutes += minutes;
+        }
+    }
+
+    // Sweep each day in start order, keeping the bookings still running
+    std::vector<Booking> running;
+    for (int day = 0; day < MeetingPattern::DAYS; ++day) {
+        std::vector<Booking>& bookings = state.days[day];
+        std::sort(bookings.begin(), bookings.end(), [](const Booking& a, const Booking& b) {
+            return a.start != b.start ? a.start < b.start : a.section < b.section;
+        });
+
+        running.clear();
+        for (const Booking& booking : bookings) {
+            running.erase(std::remove_if(running.begin(), running.end(),
+                                         [&booking](const Booking& other) { return other.end <= booking.start; }),
+                          running.end());
+            for (const Booking& other : running) {
+                // Same test as PackedTimeSlot::overlaps; only an empty booking can fail it here
+                if (other.section != booking.section && other.start < booking.end) {
+                    state.conflicts.push_back(std::make_pair(std::min(other.section, booking.section),
+                                                             std::max(other.section, booking.section)));
+                }
+            }
+            running.push_back(booking);
+        }
+    }
+
+    std::sort(state.conflicts.begin(), state.conflicts.end());
+    state.conflicts.erase(std::unique(state.conflicts.begin(), state.conflicts.end()), state.conflicts.end());
+}
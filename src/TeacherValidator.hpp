@@ -0,0 +1,93 @@
+#ifndef TEACHER_VALIDATOR_HPP
+#define TEACHER_VALIDATOR_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Teaching time a teacher may carry; zero means no limit
+struct TeacherLoadLimits {
+    int maxWeeklyMinutes = 20 * 60;
+    int maxDailyMinutes = 0;
+};
+
+// Two sections of the same teacher that meet at the same time; first was added earlier
+struct DoubleBooking {
+    std::shared_ptr<Teacher> teacher;
+    std::shared_ptr<Section> first;
+    std::shared_ptr<Section> second;
+};
+
+struct LoadViolation {
+    std::shared_ptr<Teacher> teacher;
+    int day = -1;      // weekday of a daily limit, -1 for the weekly one
+    int minutes = 0;   // teaching time scheduled
+    int limit = 0;
+};
+
+struct TeacherValidation {
+    std::vector<DoubleBooking> doubleBookings;
+    std::vector<LoadViolation> loadViolations;
+    size_t teachers = 0;
+    size_t sections = 0;
+
+    bool isValid() const { return doubleBookings.empty() && loadViolations.empty(); }
+};
+
+// Catalog-wide checks that no teacher is in two places at once and none
+// teaches more than the load limits allow. Sections are grouped by teacher,
+// and each teacher keeps its meetings sorted by start per weekday. Adding a
+// section only compares its meetings with that teacher's neighbours on the
+// same day. A full recheck sweeps every teacher again, spread over threads,
+// for when sections were edited in place.
+class TeacherValidator {
+public:
+    explicit TeacherValidator(const TeacherLoadLimits& limits = TeacherLoadLimits());
+
+    void setLimits(const TeacherLoadLimits& limits);
+    const TeacherLoadLimits& getLimits() const;
+
+    void clear();
+
+    // Checks the new section against its teacher's other sections
+    void addSection(std::shared_ptr<Section> section);
+
+    // Regroups every section and sweeps each teacher again; zero threads uses
+    // one per hardware thread
+    void recheckAll(size_t threads = 0);
+
+    // Every double booking, in the order the later section was added, and
+    // every limit exceeded
+    TeacherValidation getValidation() const;
+
+private:
+    // One meeting of a section, in minutes of its day
+    struct Booking {
+        int start;
+        int end;
+        int section;
+    };
+
+    struct TeacherState {
+        std::shared_ptr<Teacher> teacher;
+        std::vector<int> sections;
+        std::vector<Booking> days[MeetingPattern::DAYS];
+        int longest[MeetingPattern::DAYS];       // longest booking per day, bounds the backward scan
+        int dayMinutes[MeetingPattern::DAYS];
+        int weekMinutes;
+        std::vector<std::pair<int, int>> conflicts;  // section pairs, earlier first
+    };
+
+    TeacherLoadLimits limits;
+    std::vector<std::shared_ptr<Section>> sections;
+    std::vector<TeacherState> states;
+    std::unordered_map<const Teacher*, size_t> stateByTeacher;
+
+    TeacherState& stateFor(std::shared_ptr<Teacher> teacher);
+    void insert(TeacherState& state, int section);
+    static void resetBookings(TeacherState& state);
+    void sweep(TeacherState& state) const;
+};
+
+#endif // TEACHER_VALIDATOR_HPP
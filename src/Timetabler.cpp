@@ -0,0 +1,311 @@
+#include "Timetabler.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <unordered_map>
+
+namespace {
+
+bool intervalsOverlap(int dayA, int startA, int endA, int dayB, int startB, int endB) {
+    return dayA == dayB && startA < endB && startB < endA;
+}
+
+}
+
+Timetabler::Timetabler(const TimetableOptions& options)
+    : options(options) {}
+
+void Timetabler::addSection(std::shared_ptr<Section> section) {
+    indexOf(section);
+}
+
+void Timetabler::addCohort(const std::vector<std::shared_ptr<Section>>& cohort) {
+    std::vector<int> members;
+    for (const auto& section : cohort) {
+        members.push_back(indexOf(section));
+    }
+    cohorts.push_back(members);
+}
+
+int Timetabler::indexOf(const std::shared_ptr<Section>& section) {
+    auto inserted = sectionIndex.emplace(section.get(), static_cast<int>(sections.size()));
+    if (inserted.second) sections.push_back(section);
+    return inserted.first->second;
+}
+
+TimetableResult Timetabler::run() {
+    TimetableResult result;
+    auto startTime = std::chrono::steady_clock::now();
+
+    buildCandidates(result);
+    buildNeighbors();
+
+    conflictTable.assign(sections.size(), std::vector<int>());
+    freeCount.assign(sections.size(), 0);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        conflictTable[i].assign(candidates[i].size(), 0);
+        freeCount[i] = static_cast<int>(candidates[i].size());
+    }
+    current.assign(sections.size(), -1);
+
+    seedWithDSatur();
+    improveWithTabu(result);
+
+    // Write the chosen blocks back as time slots
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (fixed[i] || current[i] < 0) continue;
+
+        const Placement& placement = candidates[i][current[i]];
+        sections[i]->setTimeSlot(std::make_shared<TimeSlot>(
+            static_cast<TimeSlot::Day>(placement.day), placement.start / 60, placement.start % 60,
+            placement.end - placement.start));
+        result.assigned++;
+    }
+
+    result.conflicts = countConflicts();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+void Timetabler::buildCandidates(TimetableResult& result) {
+    candidates.assign(sections.size(), std::vector<Placement>());
+    fixed.assign(sections.size(), false);
+
+    // Placements index a per-minute table of the week, so the day stays within midnight to midnight
+    int dayStart = std::max(0, std::min(options.dayStartHour, 24)) * 60;
+    int dayEnd = std::max(0, std::min(options.dayEndHour, 24)) * 60;
+
+    // Starts step by whole periods, so a period shorter than a minute would never reach the end of the day
+    int period = std::max(1, std::min(options.periodMinutes, 24 * 60));
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        auto pattern = sections[i]->getMeetingPattern();
+        if (options.keepExisting && pattern) {
+            PackedTimeSlot first = pattern->getMeetings().front();
+            candidates[i].push_back(Placement{first.getDay(), first.getStartMinute(), first.getEndMinute(),
+                                              pattern->getMeetings().size() > 1 ? pattern.get() : nullptr});
+            fixed[i] = true;
+            continue;
+        }
+
+        // Credit hours decide the block length; blocks never wrap past the end of the day
+        int length = std::max(1, sections[i]->getCourse()->getCredits()) * period;
+        if (length > dayEnd - dayStart) {
+            fixed[i] = true;
+            result.unplaceable++;
+            continue;
+        }
+
+        for (int day = TimeSlot::MONDAY; day <= TimeSlot::FRIDAY; ++day) {
+            for (int start = dayStart; start + length <= dayEnd; start += period) {
+                candidates[i].push_back(Placement{day, start, start + length});
+            }
+        }
+    }
+}
+
+void Timetabler::buildNeighbors() {
+    neighbors.assign(sections.size(), std::vector<int>());
+
+    // Sections clash through a shared teacher or a shared cohort
+    std::vector<std::vector<int>> groups = cohorts;
+    std::unordered_map<const Teacher*, size_t> teacherGroups;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const Teacher* teacher = sections[i]->getTeacher().get();
+        if (!teacher) continue;
+
+        auto it = teacherGroups.find(teacher);
+        if (it == teacherGroups.end()) {
+            teacherGroups[teacher] = groups.size();
+            groups.push_back(std::vector<int>(1, static_cast<int>(i)));
+        } else {
+            groups[it->second].push_back(static_cast<int>(i));
+        }
+    }
+
+    for (const auto& group : groups) {
+        for (size_t a = 0; a < group.size(); ++a) {
+            for (size_t b = a + 1; b < group.size(); ++b) {
+                if (group[a] == group[b]) continue;
+                neighbors[group[a]].push_back(group[b]);
+                neighbors[group[b]].push_back(group[a]);
+            }
+        }
+    }
+
+    for (auto& list : neighbors) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+}
+
+bool Timetabler::overlaps(const Placement& a, const Placement& b) {
+    if (a.pattern && b.pattern) return a.pattern->overlaps(*b.pattern);
+    if (a.pattern) return a.pattern->overlaps(PackedTimeSlot(b.day, b.start, b.end - b.start));
+    if (b.pattern) return b.pattern->overlaps(PackedTimeSlot(a.day, a.start, a.end - a.start));
+    return intervalsOverlap(a.day, a.start, a.end, b.day, b.start, b.end);
+}
+
+void Timetabler::place(int section, int candidate) {
+    int previous = current[section];
+    for (int other : neighbors[section]) {
+        for (size_t k = 0; k < candidates[other].size(); ++k) {
+            const Placement& target = candidates[other][k];
+            if (previous >= 0) {
+                const Placement& from = candidates[section][previous];
+                if (overlaps(from, target) &&
+                    --conflictTable[other][k] == 0) {
+                    freeCount[other]++;
+                }
+            }
+            if (candidate >= 0) {
+                const Placement& to = candidates[section][candidate];
+                if (overlaps(to, target) &&
+                    conflictTable[other][k]++ == 0) {
+                    freeCount[other]--;
+                }
+            }
+        }
+    }
+    current[section] = candidate;
+}
+
+size_t Timetabler::countConflicts() const {
+    size_t total = 0;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (current[i] >= 0) {
+            total += conflictTable[i][current[i]];
+        }
+    }
+    return total / 2;
+}
+
+void Timetabler::seedWithDSatur() {
+    // Sections that keep their existing slot are placed first
+    std::vector<int> pending;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (candidates[i].empty()) continue;
+        if (fixed[i]) {
+            place(static_cast<int>(i), 0);
+        } else {
+            pending.push_back(static_cast<int>(i));
+        }
+    }
+
+    // How many sections already start at each (day, minute), used to spread load
+    std::vector<int> usage(5 * 24 * 60, 0);
+
+    while (!pending.empty()) {
+        // Most saturated section first: fewest clash-free placements left, then highest degree
+        size_t pick = 0;
+        int pickFree = INT_MAX;
+        for (size_t p = 0; p < pending.size(); ++p) {
+            int section = pending[p];
+            int free = freeCount[section];
+            if (free < pickFree ||
+                (free == pickFree && neighbors[section].size() > neighbors[pending[pick]].size())) {
+                pick = p;
+                pickFree = free;
+            }
+        }
+
+        int section = pending[pick];
+        pending[pick] = pending.back();
+        pending.pop_back();
+
+        // Clash-free placement that is least used so far, otherwise the fewest clashes
+        int bestCandidate = 0;
+        for (size_t k = 1; k < candidates[section].size(); ++k) {
+            const Placement& a = candidates[section][k];
+            const Placement& b = candidates[section][bestCandidate];
+            int clashA = conflictTable[section][k];
+            int clashB = conflictTable[section][bestCandidate];
+            if (clashA < clashB ||
+                (clashA == clashB && usage[a.day * 1440 + a.start] < usage[b.day * 1440 + b.start])) {
+                bestCandidate = static_cast<int>(k);
+            }
+        }
+
+        place(section, bestCandidate);
+        const Placement& chosen = candidates[section][bestCandidate];
+        usage[chosen.day * 1440 + chosen.start]++;
+    }
+}
+
+void Timetabler::improveWithTabu(TimetableResult& result) {
+    long total = static_cast<long>(countConflicts());
+    if (total == 0) return;
+
+    Random random(options.seed);
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<long>> tabuUntil(sections.size());
+    for (size_t i = 0; i < sections.size(); ++i) {
+        tabuUntil[i].assign(candidates[i].size(), 0);
+    }
+
+    long best = total;
+    std::vector<int> bestAssignment = current;
+    long iteration = 0;
+
+    for (; iteration < options.maxIterations && total > 0; ++iteration) {
+        if ((iteration & 255) == 0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (elapsed > options.timeLimitSeconds) break;
+        }
+
+        // Best non-tabu move of a clashing section; tabu moves are allowed if they beat the best
+        int moveSection = -1;
+        int moveCandidate = -1;
+        int bestDelta = INT_MAX;
+        int ties = 0;
+        int clashing = 0;
+
+        for (size_t i = 0; i < sections.size(); ++i) {
+            if (fixed[i] || current[i] < 0) continue;
+            int here = conflictTable[i][current[i]];
+            if (here == 0) continue;
+            clashing++;
+
+            for (size_t k = 0; k < candidates[i].size(); ++k) {
+                if (static_cast<int>(k) == current[i]) continue;
+                int delta = conflictTable[i][k] - here;
+                if (tabuUntil[i][k] > iteration && total + delta >= best) continue;
+
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    moveSection = static_cast<int>(i);
+                    moveCandidate = static_cast<int>(k);
+                    ties = 1;
+                } else if (delta == bestDelta && random.nextIndex(++ties) == 0) {
+                    moveSection = static_cast<int>(i);
+                    moveCandidate = static_cast<int>(k);
+                }
+            }
+        }
+
+        if (moveSection < 0) break;
+
+        int previous = current[moveSection];
+        place(moveSection, moveCandidate);
+        total += bestDelta;
+        tabuUntil[moveSection][previous] = iteration + 10 + static_cast<long>(random.nextIndex(10)) + (6 * clashing) / 10;
+
+        if (total < best) {
+            best = total;
+            bestAssignment = current;
+        }
+    }
+
+    result.iterations = iteration;
+
+    // Go back to the best assignment seen if the search wandered off it
+    if (total > best) {
+        for (size_t i = 0; i < sections.size(); ++i) {
+            if (current[i] != bestAssignment[i]) {
+                place(static_cast<int>(i), bestAssignment[i]);
+            }
+        }
+    }
+}
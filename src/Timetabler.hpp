@@ -0,0 +1,88 @@
+#ifndef TIMETABLER_HPP
+#define TIMETABLER_HPP
+
+#include "Models.hpp"
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Options for institution-wide time slot assignment
+struct TimetableOptions {
+    int dayStartHour = 8;
+    int dayEndHour = 18;
+
+    // One credit hour is one period; a section needs a block of credits periods
+    int periodMinutes = 60;
+
+    // Sections that already have a time slot stay where they are
+    bool keepExisting = true;
+
+    // Limits for the tabu improvement phase
+    long maxIterations = 500000;
+    double timeLimitSeconds = 30.0;
+    uint64_t seed = 1;
+};
+
+struct TimetableResult {
+    size_t assigned = 0;      // sections given a new time slot
+    size_t unplaceable = 0;   // blocks longer than a day, left untouched
+    size_t conflicts = 0;     // teacher/cohort clashes still present
+    long iterations = 0;      // tabu moves made
+    double seconds = 0.0;
+};
+
+// Assigns a TimeSlot to every section so that no teacher teaches two
+// overlapping sections and no cohort (a group of sections taken together by
+// the same students) has two overlapping sections.
+// A DSatur greedy pass gives the initial assignment and a tabu search over
+// single-section moves removes the remaining clashes.
+class Timetabler {
+public:
+    Timetabler(const TimetableOptions& options = TimetableOptions());
+
+    void addSection(std::shared_ptr<Section> section);
+    void addCohort(const std::vector<std::shared_ptr<Section>>& cohort);
+
+    // Runs both phases and writes the time slots back to the sections
+    TimetableResult run();
+
+private:
+    // A place a section can go: day and start/end in minutes from midnight.
+    // A kept section that meets several times a week also carries its pattern,
+    // and day/start/end are its first meeting.
+    struct Placement {
+        int day;
+        int start;
+        int end;
+        const MeetingPattern* pattern = nullptr;
+    };
+
+    TimetableOptions options;
+    std::vector<std::shared_ptr<Section>> sections;
+    std::unordered_map<const Section*, int> sectionIndex;
+    std::vector<std::vector<int>> cohorts;
+
+    std::vector<std::vector<Placement>> candidates;
+    std::vector<std::vector<int>> neighbors;
+    std::vector<bool> fixed;
+
+    // conflictTable[i][k]: placed neighbors of i that overlap candidate k of i
+    std::vector<std::vector<int>> conflictTable;
+    std::vector<int> freeCount; // candidates of i with no clash, the DSatur saturation
+    std::vector<int> current;
+
+    // Helper method to number a section on first sight
+    int indexOf(const std::shared_ptr<Section>& section);
+
+    void buildCandidates(TimetableResult& result);
+    void buildNeighbors();
+    static bool overlaps(const Placement& a, const Placement& b);
+    void place(int section, int candidate);
+    size_t countConflicts() const;
+
+    void seedWithDSatur();
+    void improveWithTabu(TimetableResult& result);
+};
+
+#endif // TIMETABLER_HPP
@@ -10,6 +10,7 @@
 
 #include "Scheduler.hpp"
 #include "PQTree.hpp"
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -217,10 +218,17 @@ private:
     TextInput* startHourInput;
     TextInput* startMinuteInput;
     TextInput* durationInput;
+    TextInput* capacityInput;
+    std::string timetableStatus;
+    std::future<RushResult> rush;  // valid while a registration rush runs in the background
     
     void refreshSectionList();
     void refreshDropdowns();
     void addSection();
+    void assignTimeSlots();
+    void assignTeachers();
+    void simulateRush();
+    void showRushResult(const RushResult& result);
 };
 
 class RequirementManagementScreen : public Screen {
@@ -242,6 +250,7 @@ private:
     TextInput* startHourInput;
     TextInput* startMinuteInput;
     TextInput* durationInput;
+    TextInput* weightInput;
     
     void refreshRequirementList();
     void refreshDropdowns();
@@ -258,11 +267,40 @@ public:
     ScreenState processInput() override;
     
 private:
-    std::vector<std::shared_ptr<Schedule>> displayedSchedules;
+    // Schedules stay compact in the scheduler; only the one on screen is expanded
+    size_t displayedScheduleCount;
+    std::shared_ptr<Schedule> displayedSchedule;
     int currentScheduleIndex;
+    ConflictExplanation conflictExplanation;
+    ScheduleCount scheduleCount;
+    
+    // When set, Previous and Next page through the trade-off front instead
+    std::vector<ParetoSchedule> paretoFront;
+    bool showingTradeOffs;
+    
+    // Set after Re-solve, until the next full generation
+    bool showingRepair;
+    
+    // Set when no schedule covers every course and the best partial one is shown
+    bool showingPartial;
+    
+    // Browse all pages through every valid schedule, pulled from a stream one
+    // Next at a time; the ones already seen stay for Previous
+    ScheduleStream browseStream;
+    std::vector<std::shared_ptr<Schedule>> browsed;
+    bool showingAll;
+    bool browseFinished;
     
     void generateSchedules();
+    void generateTradeOffs();
+    void browseAllSchedules();
+    bool browseNext();
+    void repairSchedule();
+    void showSchedule(int index);
+    std::shared_ptr<Section> findSectionAt(Vector2 position) const;
     void drawScheduleGrid();
+    void drawConflictExplanation();
+    void drawConflictSummary();
     void drawSelectedSchedule();
 };
 
@@ -1,72 +1,443 @@
 #include "Scheduler.hpp"
 #include <algorithm>
+#include <chrono>
 #include <map>
+#include <queue>
 #include <set>
-#include <random>
+#include <unordered_map>
 
 Scheduler::Scheduler() {
     clear();
 }
 
 void Scheduler::addCourse(std::shared_ptr<Course> course) {
-    if (std::find(courses.begin(), courses.end(), course) == courses.end()) {
+    if (added.insert(course.get()).second) {
         courses.push_back(course);
+        coursesByCode.emplace(course->getCode(), course);
     }
 }
 
 void Scheduler::addTeacher(std::shared_ptr<Teacher> teacher) {
-    if (std::find(teachers.begin(), teachers.end(), teacher) == teachers.end()) {
+    if (added.insert(teacher.get()).second) {
         teachers.push_back(teacher);
+        teachersById.emplace(teacher->getId(), teacher);
     }
 }
 
 void Scheduler::addSection(std::shared_ptr<Section> section) {
-    if (std::find(sections.begin(), sections.end(), section) == sections.end()) {
+    if (added.insert(section.get()).second) {
         sections.push_back(section);
+        sectionsById.emplace(section->getId(), section);
+        catalogIndexStale = true;
+        teacherValidator.addSection(section);
         
         // Add the section to its course
         section->getCourse()->addSection(section);
         
-        // Add the course to the teacher's list of courses
-        section->getTeacher()->addCourse(section->getCourse());
+        // Add the course to the teacher's list of courses; sections without one wait for assignTeachers()
+        if (section->getTeacher()) {
+            section->getTeacher()->addCourse(section->getCourse());
+        }
+    }
+}
+
+void Scheduler::addRoom(std::shared_ptr<Room> room) {
+    if (added.insert(room.get()).second) {
+        rooms.push_back(room);
+        roomsById.emplace(room->getId(), room);
     }
 }
 
 void Scheduler::addRequirement(std::shared_ptr<Requirement> requirement) {
-    if (std::find(requirements.begin(), requirements.end(), requirement) == requirements.end()) {
+    if (added.insert(requirement.get()).second) {
         requirements.push_back(requirement);
     }
 }
 
-bool Scheduler::generateSchedule() {
+void Scheduler::addPreference(std::shared_ptr<Preference> preference) {
+    if (added.insert(preference.get()).second) {
+        preferences.push_back(preference);
+    }
+}
+
+bool Scheduler::generateSchedule(const SolveOptions& options) {
+    auto startTime = std::chrono::steady_clock::now();
+    
     // Clear any existing schedules
-    possibleSchedules.clear();
+    schedulePool.reset(0);
     currentSchedule = nullptr;
+    lastSolveStats = SolveStats();
+    lastPortfolioStats.clear();
     
     // Build the PQ tree from the course and section data
     buildPQTree();
     
+    // Lower the requirements into section masks once per generation
+    compiledRequirements.compile(courses, requirements);
+    scoreModel.build(courses, preferences);
+    
     // Apply the PQ tree operations to generate schedules
-    extractSchedulesFromPQTree();
+    extractSchedulesFromPQTree(options);
     
     // Find a schedule that satisfies all requirements
-    return findSatisfyingSchedule();
+    if (findSatisfyingSchedule()) {
+        return true;
+    }
+    
+    // Rather than an arbitrary schedule, the one keeping the most credits, within
+    // whatever budget the search left; a spent limit still allows a first dive
+    if (options.bestPartial) {
+        PartialOptions partialOptions;
+        partialOptions.memoryLimitBytes = options.memoryLimitBytes;
+        if (options.timeLimitSeconds > 0.0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            partialOptions.timeLimitSeconds = std::max(1e-3, options.timeLimitSeconds - elapsed);
+        } else {
+            partialOptions.timeLimitSeconds = 0.0;
+        }
+        if (options.nodeLimit > 0) {
+            partialOptions.nodeLimit = options.nodeLimit > lastSolveStats.nodes ?
+                options.nodeLimit - lastSolveStats.nodes : 1;
+        }
+        currentSchedule = solvePartial(partialOptions);
+    } else if (!schedulePool.empty()) {
+        currentSchedule = getSchedule(0);
+    }
+    return false;
+}
+
+void Scheduler::setSeed(uint64_t seed) {
+    random.seed(seed);
+}
+
+const SolveStats& Scheduler::getLastSolveStats() const {
+    return lastSolveStats;
+}
+
+const std::vector<StrategyStats>& Scheduler::getLastPortfolioStats() const {
+    return lastPortfolioStats;
 }
 
 std::shared_ptr<Schedule> Scheduler::getCurrentSchedule() const {
     return currentSchedule;
 }
 
+size_t Scheduler::getScheduleCount() const {
+    return schedulePool.size();
+}
+
+std::shared_ptr<Schedule> Scheduler::getSchedule(size_t index) const {
+    return makeSchedule(schedulePool.getChoice(static_cast<SchedulePool::Handle>(index)));
+}
+
 std::vector<std::shared_ptr<Schedule>> Scheduler::getAllPossibleSchedules() const {
-    return possibleSchedules;
+    std::vector<std::shared_ptr<Schedule>> schedules;
+    for (size_t i = 0; i < schedulePool.size(); ++i) {
+        schedules.push_back(getSchedule(i));
+    }
+    return schedules;
+}
+
+std::vector<std::shared_ptr<Schedule>> Scheduler::getRankedSchedules(size_t count) const {
+    std::vector<SchedulePool::Handle> handles(schedulePool.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        handles[i] = static_cast<SchedulePool::Handle>(i);
+    }
+    std::stable_sort(handles.begin(), handles.end(), [this](SchedulePool::Handle a, SchedulePool::Handle b) {
+        return schedulePool.getScore(a) > schedulePool.getScore(b);
+    });
+    
+    std::vector<std::shared_ptr<Schedule>> schedules;
+    for (size_t i = 0; i < handles.size() && i < count; ++i) {
+        schedules.push_back(makeSchedule(schedulePool.getChoice(handles[i])));
+    }
+    return schedules;
+}
+
+ScheduleStream Scheduler::streamSchedules() {
+    compiledRequirements.compile(courses, requirements);
+    if (compiledRequirements.isUnsatisfiable()) {
+        return ScheduleStream();
+    }
+    scoreModel.build(courses, preferences);
+    
+    auto streamSolver = std::make_shared<ScheduleSolver>();
+    streamSolver->build(courses, compiledRequirements, scoreModel);
+    return ScheduleStream(courses, streamSolver);
+}
+
+float Scheduler::getScheduleScore(const Schedule& schedule) const {
+    return scoreModel.normalize(scoreModel.evaluate(getChoiceForSchedule(schedule)));
+}
+
+std::vector<std::shared_ptr<Section>> Scheduler::getEquivalentSections(const Section& section) const {
+    std::vector<std::shared_ptr<Section>> equivalent;
+    int courseIndex = compiledRequirements.getCourseIndex(section.getCourse().get());
+    int sectionIndex = compiledRequirements.getSectionIndex(&section);
+    if (courseIndex < 0 || sectionIndex < 0 || static_cast<size_t>(courseIndex) >= solver.getCourseCount()) {
+        return equivalent;
+    }
+    
+    const auto& sections = courses[courseIndex]->getSections();
+    for (const auto& sectionClass : solver.getClasses(courseIndex)) {
+        const auto& members = sectionClass.members;
+        if (std::find(members.begin(), members.end(), sectionIndex) == members.end()) continue;
+        for (int member : members) {
+            if (member != sectionIndex && static_cast<size_t>(member) < sections.size()) {
+                equivalent.push_back(sections[member]);
+            }
+        }
+    }
+    return equivalent;
+}
+
+void Scheduler::setCompactnessWeights(const CompactnessWeights& weights) {
+    compactness.setWeights(weights);
+}
+
+CompactnessReport Scheduler::getScheduleCompactness(const Schedule& schedule) const {
+    return compactness.measure(schedule);
+}
+
+std::vector<ParetoSchedule> Scheduler::generateParetoFront(const ParetoOptions& options) {
+    compiledRequirements.compile(courses, requirements);
+    scoreModel.build(courses, preferences);
+    solver.build(courses, compiledRequirements, scoreModel);
+    paretoSolver.build(solver);
+    lastParetoResult = paretoSolver.run(options);
+    
+    std::vector<ParetoSchedule> front;
+    for (const auto& point : paretoSolver.getFront()) {
+        ParetoSchedule entry;
+        entry.schedule = makeSchedule(solver.expandFirst(point.choice));
+        entry.preferenceScore = scoreModel.normalize(point.preference);
+        entry.compactness = point.compactness;
+        front.push_back(entry);
+    }
+    
+    // A requirement on a course that is not being scheduled rules out everything
+    if (compiledRequirements.isUnsatisfiable()) front.clear();
+    return front;
+}
+
+const ParetoResult& Scheduler::getLastParetoResult() const {
+    return lastParetoResult;
+}
+
+void Scheduler::pinSection(std::shared_ptr<Section> section) {
+    if (!isPinned(*section)) {
+        pinnedSections.push_back(section);
+    }
+}
+
+void Scheduler::unpinSection(std::shared_ptr<Section> section) {
+    pinnedSections.erase(std::remove(pinnedSections.begin(), pinnedSections.end(), section), pinnedSections.end());
+}
+
+bool Scheduler::isPinned(const Section& section) const {
+    for (const auto& pinned : pinnedSections) {
+        if (pinned.get() == &section) return true;
+    }
+    return false;
+}
+
+const std::vector<std::shared_ptr<Section>>& Scheduler::getPinnedSections() const {
+    return pinnedSections;
+}
+
+bool Scheduler::repairSchedule(const Schedule& previous, const RepairOptions& options) {
+    compiledRequirements.compile(courses, requirements);
+    scoreModel.build(courses, preferences);
+    solver.build(courses, compiledRequirements, scoreModel);
+    repairer.build(courses, solver);
+    
+    // The first pin of a course wins; pins of courses no longer scheduled are ignored
+    std::vector<int> pins(courses.size(), -1);
+    for (const auto& section : pinnedSections) {
+        int courseIndex = compiledRequirements.getCourseIndex(section->getCourse().get());
+        int sectionIndex = compiledRequirements.getSectionIndex(section.get());
+        if (courseIndex >= 0 && sectionIndex >= 0 && sectionIndex < SchedulePool::NO_SECTION &&
+            pins[courseIndex] < 0) {
+            pins[courseIndex] = sectionIndex;
+        }
+    }
+    
+    lastRepairResult = repairer.run(getChoiceForSchedule(previous), pins, options);
+    if (!lastRepairResult.complete) {
+        return false;
+    }
+    
+    const std::vector<int>& choice = repairer.getChoice();
+    schedulePool.reset(courses.size());
+    schedulePool.add(choice, scoreModel.evaluate(choice));
+    currentSchedule = getSchedule(0);
+    return compiledRequirements.isSatisfied(choice);
+}
+
+const RepairResult& Scheduler::getLastRepairResult() const {
+    return lastRepairResult;
+}
+
+void Scheduler::setCoursePriority(std::shared_ptr<Course> course, float priority) {
+    coursePriorities[course.get()] = priority;
+}
+
+float Scheduler::getCoursePriority(const Course& course) const {
+    auto it = coursePriorities.find(&course);
+    return it != coursePriorities.end() ? it->second : 1.0f;
+}
+
+std::shared_ptr<Schedule> Scheduler::generateBestPartialSchedule(const PartialOptions& options) {
+    compiledRequirements.compile(courses, requirements);
+    scoreModel.build(courses, preferences);
+    solver.build(courses, compiledRequirements, scoreModel);
+    currentSchedule = solvePartial(options);
+    return currentSchedule;
+}
+
+const PartialResult& Scheduler::getLastPartialResult() const {
+    return lastPartialResult;
+}
+
+TeacherValidation Scheduler::validateTeachers(bool recheckAll) {
+    if (recheckAll || teacherValidatorStale) {
+        teacherValidator.recheckAll();
+        teacherValidatorStale = false;
+    }
+    return teacherValidator.getValidation();
+}
+
+void Scheduler::setTeacherLoadLimits(const TeacherLoadLimits& limits) {
+    teacherValidator.setLimits(limits);
+}
+
+ConflictExplanation Scheduler::explainConflicts(const ConflictOptions& options) const {
+    ConflictExplainer explainer(options);
+    for (const auto& course : courses) {
+        explainer.addCourse(course);
+    }
+    for (const auto& requirement : requirements) {
+        explainer.addRequirement(requirement);
+    }
+    return explainer.run();
+}
+
+ScheduleCount Scheduler::countValidSchedules(size_t maxStates, double timeLimitSeconds) {
+    return buildCounter(maxStates, timeLimitSeconds);
+}
+
+std::vector<std::shared_ptr<Schedule>> Scheduler::sampleValidSchedules(size_t count, size_t maxStates) {
+    std::vector<std::shared_ptr<Schedule>> samples;
+    ScheduleCount total = buildCounter(maxStates, 0.0);
+    if (total.count <= 0.0) return samples;
+    
+    std::vector<int> choice;
+    for (size_t i = 0; i < count; ++i) {
+        if (!counter.sample(random, choice)) break;
+        samples.push_back(makeSchedule(choice));
+    }
+    return samples;
+}
+
+std::vector<std::shared_ptr<Section>> Scheduler::findFittingSections(const Schedule& schedule, bool otherCoursesOnly) {
+    if (catalogIndexStale) {
+        catalogIndex.build(sections);
+        catalogIndexStale = false;
+    }
+    return catalogIndex.findFitting(schedule, otherCoursesOnly);
+}
+
+std::vector<TimeSlot> Scheduler::findFreeWindows(const Schedule& schedule, int minMinutes,
+                                                 int dayStartHour, int dayEndHour) const {
+    return CatalogIndex::findFreeWindows(schedule, minMinutes, dayStartHour, dayEndHour);
+}
+
+void Scheduler::addCohort(const std::vector<std::shared_ptr<Section>>& cohort) {
+    cohorts.push_back(cohort);
+}
+
+TimetableResult Scheduler::assignTimeSlots(const TimetableOptions& options) {
+    Timetabler timetabler(options);
+    for (const auto& section : sections) {
+        timetabler.addSection(section);
+    }
+    for (const auto& cohort : cohorts) {
+        timetabler.addCohort(cohort);
+    }
+    
+    // Old schedules may reference the previous times
+    schedulePool.reset(0);
+    currentSchedule = nullptr;
+    catalogIndexStale = true;
+    teacherValidatorStale = true;
+    
+    return timetabler.run();
+}
+
+RoomAssignmentResult Scheduler::assignRooms() {
+    RoomAssigner assigner;
+    for (const auto& room : rooms) {
+        assigner.addRoom(room);
+    }
+    for (const auto& section : sections) {
+        assigner.addSection(section);
+    }
+    return assigner.run();
+}
+
+TeacherAssignmentResult Scheduler::assignTeachers(const TeacherAssignmentOptions& options) {
+    TeacherAssigner assigner(options);
+    for (const auto& teacher : teachers) {
+        assigner.addTeacher(teacher);
+    }
+    for (const auto& section : sections) {
+        assigner.addSection(section);
+    }
+    for (const auto& requirement : requirements) {
+        assigner.addRequirement(requirement);
+    }
+    
+    // Teachers changed in place, and scores may depend on them
+    schedulePool.reset(0);
+    currentSchedule = nullptr;
+    teacherValidatorStale = true;
+    
+    return assigner.run();
+}
+
+EnrollmentResult Scheduler::allocateSeats(const std::vector<std::vector<std::shared_ptr<Schedule>>>& students,
+                                          const EnrollmentOptions& options) {
+    EnrollmentAllocator allocator;
+    for (const auto& alternatives : students) {
+        allocator.addStudent(alternatives);
+    }
+    return allocator.run(options);
+}
+
+RushResult Scheduler::simulateRegistrationRush(const RushOptions& options) {
+    RegistrationSimulator simulator(courses);
+    return simulator.run(options);
 }
 
 void Scheduler::clear() {
     courses.clear();
     teachers.clear();
     sections.clear();
+    rooms.clear();
     requirements.clear();
-    possibleSchedules.clear();
+    preferences.clear();
+    cohorts.clear();
+    pinnedSections.clear();
+    coursePriorities.clear();
+    coursesByCode.clear();
+    teachersById.clear();
+    sectionsById.clear();
+    roomsById.clear();
+    added.clear();
+    catalogIndexStale = true;
+    teacherValidator.clear();
+    teacherValidatorStale = false;
+    schedulePool.reset(0);
     currentSchedule = nullptr;
 }
 
@@ -82,10 +453,38 @@ const std::vector<std::shared_ptr<Section>>& Scheduler::getSections() const {
     return sections;
 }
 
+const std::vector<std::shared_ptr<Room>>& Scheduler::getRooms() const {
+    return rooms;
+}
+
 const std::vector<std::shared_ptr<Requirement>>& Scheduler::getRequirements() const {
     return requirements;
 }
 
+const std::vector<std::shared_ptr<Preference>>& Scheduler::getPreferences() const {
+    return preferences;
+}
+
+std::shared_ptr<Course> Scheduler::findCourse(const std::string& code) const {
+    auto it = coursesByCode.find(code);
+    return it != coursesByCode.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Teacher> Scheduler::findTeacher(const std::string& id) const {
+    auto it = teachersById.find(id);
+    return it != teachersById.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Section> Scheduler::findSection(const std::string& id) const {
+    auto it = sectionsById.find(id);
+    return it != sectionsById.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Room> Scheduler::findRoom(const std::string& id) const {
+    auto it = roomsById.find(id);
+    return it != roomsById.end() ? it->second : nullptr;
+}
+
 // Helper method to convert courses and sections to a PQ tree representation
 void Scheduler::buildPQTree() {
     // Create a new PQ tree
@@ -117,73 +516,270 @@ void Scheduler::buildPQTree() {
 }
 
 // Helper method to create actual schedules from the PQ tree layout
-void Scheduler::extractSchedulesFromPQTree() {
-    // For a simple implementation, we'll create a random number of schedules
-    // A real implementation would use more advanced algorithms
-    const int numSchedulesToGenerate = 5;
-    
-    for (int i = 0; i < numSchedulesToGenerate; ++i) {
-        // Create a new schedule
-        auto schedule = std::make_shared<Schedule>();
-        
-        // Apply some random reordering of the PQ tree
-        pqTree.reorder();
-        
-        // Now extract a schedule based on the tree's current state
-        // This is a simplified version; a real implementation would look at the tree's structure
-        // and determine the actual schedule from it
+void Scheduler::extractSchedulesFromPQTree(const SolveOptions& options) {
+    // The memory cap limits how many schedules are kept at once
+    schedulePool.reset(courses.size());
+    size_t capacity = std::max<size_t>(1, options.maxSchedules);
+    if (options.memoryLimitBytes > 0) {
+        // Pool row plus its entry in the replacement heap
+        size_t bytesPerSchedule = schedulePool.getBytesPerSchedule() + sizeof(std::pair<float, SchedulePool::Handle>);
+        capacity = std::max<size_t>(1, std::min(capacity, options.memoryLimitBytes / bytesPerSchedule));
+    }
+    
+    // Apply some random reordering of the PQ tree; its leaf order becomes the
+    // order in which the solver tries sections, so each generation differs
+    pqTree.reorder(random);
+    
+    // Sections that no requirement or preference can tell apart are searched once
+    std::vector<std::vector<int>> rank = getSectionOrderFromPQTree();
+    solver.build(courses, compiledRequirements, scoreModel);
+    solver.setSectionOrder(rank);
+    solver.setCompactness(&compactness);
+    
+    SearchLimits limits;
+    limits.timeLimitSeconds = options.timeLimitSeconds;
+    limits.nodeLimit = options.nodeLimit;
+    
+    if (options.threads > 1) {
+        runPortfolio(options, capacity, limits, rank);
+        return;
+    }
+    
+    // Courses that cannot clash with each other are searched separately and the
+    // best combinations are merged, instead of one search over their product.
+    // Compactness ties together every course that meets on the same day, so
+    // it needs the whole week in one search.
+    std::vector<std::vector<int>> components = solver.getComponents();
+    if (components.size() > 1 && !compactness.isActive()) {
+        componentSolver.build(courses, requirements, preferences, components, rank);
+        SearchResult result = componentSolver.solve(capacity, limits);
+        componentSolver.merge(capacity, [this](const std::vector<int>& choice, float score) {
+            schedulePool.add(choice, score);
+            return true;
+        });
+        recordSolveStats(result);
+        return;
+    }
+    
+    // Keep the first schedules found; once full, only better ones replace the worst kept
+    typedef std::pair<float, SchedulePool::Handle> Kept;
+    std::priority_queue<Kept, std::vector<Kept>, std::greater<Kept>> worstKept;
+    std::vector<std::vector<int>> expanded;
+    SearchResult result = solver.search([&](const std::vector<int>& classChoice, float score) {
+        if (schedulePool.size() == capacity && score <= worstKept.top().first) return true;
         
-        // For each course, add one section to the schedule
-        for (const auto& course : courses) {
-            // Get all sections for this course
-            const auto& sections = course->getSections();
-            
-            if (!sections.empty()) {
-                // Just add a random section for now
-                std::random_device rd;
-                std::mt19937 g(rd());
-                std::uniform_int_distribution<size_t> dist(0, sections.size() - 1);
-                
-                size_t sectionIndex = dist(g);
-                schedule->addSection(sections[sectionIndex]);
+        // Equivalent sections score the same, so every combination of class members is kept as its own schedule
+        expanded.clear();
+        solver.expand(classChoice, capacity, expanded);
+        for (const auto& choice : expanded) {
+            if (schedulePool.size() < capacity) {
+                worstKept.push(Kept(score, schedulePool.add(choice, score)));
+            } else if (score > worstKept.top().first) {
+                SchedulePool::Handle handle = worstKept.top().second;
+                worstKept.pop();
+                schedulePool.assign(handle, choice, score);
+                worstKept.push(Kept(score, handle));
+            } else {
+                break;
             }
         }
         
-        // If the schedule has no conflicts, add it to the possible schedules
-        if (!schedule->hasConflicts()) {
-            possibleSchedules.push_back(schedule);
+        // Only subtrees that could still displace the worst kept are worth searching;
+        // the solver tracks the best score itself, so the reported bound stays exact
+        if (schedulePool.size() == capacity) {
+            solver.setPruneThreshold(worstKept.top().first);
         }
+        return true;
+    }, limits);
+    
+    recordSolveStats(result);
+}
+
+// Helper method to race several strategies over the built solver
+void Scheduler::runPortfolio(const SolveOptions& options, size_t capacity, const SearchLimits& limits,
+                             const std::vector<std::vector<int>>& rank) {
+    // Best preference score first, as opposed to the PQ tree order
+    std::vector<std::vector<int>> scoreRank(courses.size());
+    for (size_t i = 0; i < courses.size(); ++i) {
+        std::vector<int> bySection(courses[i]->getSections().size());
+        for (size_t j = 0; j < bySection.size(); ++j) bySection[j] = static_cast<int>(j);
+        std::stable_sort(bySection.begin(), bySection.end(), [&](int a, int b) {
+            return scoreModel.getSectionScore(i, a) > scoreModel.getSectionScore(i, b);
+        });
+        scoreRank[i].assign(bySection.size(), 0);
+        for (size_t position = 0; position < bySection.size(); ++position) {
+            scoreRank[i][bySection[position]] = static_cast<int>(position);
+        }
+    }
+    
+    SolverPortfolio portfolio;
+    uint64_t seed = random.next();
+    for (size_t t = 0; t < options.threads; ++t) {
+        if (t == 0) {
+            portfolio.addBranchAndBound("branch-and-bound (PQ order)", rank);
+        } else if (t == 1) {
+            portfolio.addLocalSearch("local search", Random::forStream(seed, t).next());
+        } else if (t == 2) {
+            portfolio.addBranchAndBound("branch-and-bound (best score first)", scoreRank);
+        } else {
+            // Further threads diversify with random value orders
+            Random stream = Random::forStream(seed, t);
+            std::vector<std::vector<int>> randomRank(courses.size());
+            for (size_t i = 0; i < courses.size(); ++i) {
+                randomRank[i].resize(courses[i]->getSections().size());
+                for (size_t j = 0; j < randomRank[i].size(); ++j) randomRank[i][j] = static_cast<int>(j);
+                stream.shuffle(randomRank[i]);
+            }
+            portfolio.addBranchAndBound("branch-and-bound (random order " + std::to_string(t - 2) + ")", randomRank);
+        }
+    }
+    
+    SearchResult result = portfolio.run(solver, &compactness, capacity, limits);
+    for (size_t s = 0; s < portfolio.getSolutions().size(); ++s) {
+        schedulePool.add(portfolio.getSolutions()[s], portfolio.getScores()[s]);
+    }
+    lastPortfolioStats = portfolio.getStats();
+    recordSolveStats(result);
+}
+
+// Helper method to scale a search score the way SolveStats reports it
+float Scheduler::normalizeObjective(float score) const {
+    // Without preferences a perfect week scores 1 and penalties count down from there
+    float maxScore = scoreModel.getMaxScore();
+    return maxScore > 0.0f ? score / maxScore : 1.0f + score;
+}
+
+// Helper method to fill the solve stats from a search result
+void Scheduler::recordSolveStats(const SearchResult& result) {
+    lastSolveStats.optimal = result.completed && result.solutions > 0;
+    lastSolveStats.budgetExhausted = !result.completed;
+    lastSolveStats.bestScore = normalizeObjective(result.bestScore);
+    lastSolveStats.bound = normalizeObjective(result.bound);
+    lastSolveStats.gap = lastSolveStats.bound - lastSolveStats.bestScore;
+    lastSolveStats.nodes = result.nodes;
+    lastSolveStats.schedules = schedulePool.size();
+    lastSolveStats.seconds = result.seconds;
+}
+
+// Helper method to compile the current data and count the valid schedules
+ScheduleCount Scheduler::buildCounter(size_t maxStates, double timeLimitSeconds) {
+    compiledRequirements.compile(courses, requirements);
+    scoreModel.build(courses, preferences);
+    solver.build(courses, compiledRequirements, scoreModel);
+    counter.build(solver);
+    
+    ScheduleCount result = counter.count(maxStates, random, timeLimitSeconds);
+    if (compiledRequirements.isUnsatisfiable()) {
+        // A requirement on a course that is not being scheduled rules out everything
+        result.count = 0.0;
+        result.exact = true;
     }
+    return result;
 }
 
 // Helper method to find a schedule that satisfies all requirements
 bool Scheduler::findSatisfyingSchedule() {
     // If no schedules were generated, return false
-    if (possibleSchedules.empty()) {
+    if (schedulePool.empty()) {
         return false;
     }
     
-    // Try to find a schedule that satisfies all requirements
-    for (const auto& schedule : possibleSchedules) {
-        bool satisfiesAll = true;
-        
-        for (const auto& requirement : requirements) {
-            if (!requirement->isSatisfied(*schedule)) {
-                satisfiesAll = false;
-                break;
-            }
+    // Among the schedules that satisfy all requirements, keep the best scoring one
+    int best = -1;
+    for (size_t i = 0; i < schedulePool.size(); ++i) {
+        SchedulePool::Handle handle = static_cast<SchedulePool::Handle>(i);
+        if (!compiledRequirements.isSatisfied(schedulePool.getChoice(handle))) {
+            continue;
         }
         
-        if (satisfiesAll) {
-            currentSchedule = schedule;
-            return true;
+        if (best < 0 || schedulePool.getScore(handle) > schedulePool.getScore(best)) {
+            best = static_cast<int>(i);
         }
     }
     
-    // If no schedule satisfies all requirements, just pick the first one
-    if (!possibleSchedules.empty()) {
-        currentSchedule = possibleSchedules[0];
+    if (best >= 0) {
+        currentSchedule = getSchedule(best);
+        return true;
     }
-    
     return false;
-} 
\ No newline at end of file
+}
+
+// Helper method to run the partial solver over the built solver
+std::shared_ptr<Schedule> Scheduler::solvePartial(const PartialOptions& options) {
+    std::vector<float> weights;
+    for (const auto& course : courses) {
+        weights.push_back(options.useCredits ? static_cast<float>(course->getCredits()) : getCoursePriority(*course));
+    }
+    partialSolver.build(solver, weights);
+    lastPartialResult = partialSolver.run(options);
+    
+    std::vector<int> choice(courses.size(), -1);
+    for (size_t i = 0; i < courses.size(); ++i) {
+        int classIndex = lastPartialResult.choice[i];
+        if (classIndex >= 0) {
+            choice[i] = solver.getClasses(i)[classIndex].members.front();
+        }
+    }
+    return makeSchedule(choice);
+}
+
+// Helper method to map a schedule to per-course section indices
+std::vector<int> Scheduler::getChoiceForSchedule(const Schedule& schedule) const {
+    std::vector<int> choice(compiledRequirements.getCourseCount(), -1);
+    for (const auto& section : schedule.getSections()) {
+        int courseIndex = compiledRequirements.getCourseIndex(section->getCourse().get());
+        if (courseIndex >= 0) {
+            choice[courseIndex] = compiledRequirements.getSectionIndex(section.get());
+        }
+    }
+    return choice;
+}
+
+// Helper method to build a schedule from per-course section indices
+std::shared_ptr<Schedule> Scheduler::makeSchedule(const std::vector<int>& choice) const {
+    auto schedule = std::make_shared<Schedule>();
+    for (size_t i = 0; i < choice.size() && i < courses.size(); ++i) {
+        if (choice[i] >= 0) {
+            schedule->addSection(courses[i]->getSections()[choice[i]]);
+        }
+    }
+    return schedule;
+}
+
+// Helper method to read the section order of every course off the PQ tree leaves
+std::vector<std::vector<int>> Scheduler::getSectionOrderFromPQTree() const {
+    std::vector<std::vector<int>> rank(courses.size());
+    auto root = pqTree.getRoot();
+    if (!root) return rank;
+    
+    std::unordered_map<std::string, size_t> courseByCode;
+    for (size_t i = 0; i < courses.size(); ++i) {
+        courseByCode.emplace(courses[i]->getCode(), i);
+        rank[i].assign(courses[i]->getSections().size(), 0);
+    }
+    
+    for (const auto& courseNode : root->getChildren()) {
+        auto it = courseByCode.find(courseNode->getLabel());
+        if (it == courseByCode.end()) continue;
+        
+        size_t courseIndex = it->second;
+        std::unordered_map<std::string, int> sectionById;
+        const auto& sections = courses[courseIndex]->getSections();
+        for (size_t j = 0; j < sections.size(); ++j) {
+            sectionById.emplace(sections[j]->getId(), static_cast<int>(j));
+        }
+        
+        // Leaves sit under the course's Q-node; their current order is the rank
+        int position = 0;
+        for (const auto& sectionsNode : courseNode->getChildren()) {
+            for (const auto& leaf : sectionsNode->getChildren()) {
+                auto section = sectionById.find(leaf->getLabel());
+                if (section != sectionById.end()) {
+                    rank[courseIndex][section->second] = position++;
+                }
+            }
+        }
+    }
+    
+    return rank;
+}
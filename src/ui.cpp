@@ -1,9 +1,21 @@
 #include "UI.hpp"
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <iostream>
 
+namespace {
+
+// Work done on the render thread for one click shares a deadline; a zero limit
+// would mean unlimited, so whatever comes last still gets a sliver
+double secondsLeft(std::chrono::steady_clock::time_point deadline) {
+    return std::max(0.01, std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count());
+}
+
+}
+
 // UIComponent implementation
 UIComponent::UIComponent(int x, int y, int width, int height)
     : x(x), y(y), width(width), height(height) {}
@@ -845,16 +857,14 @@ void TeacherManagementScreen::assignCourseToTeacher() {
     std::string courseCode = selectedCourseOption.substr(0, selectedCourseOption.find(" - "));
     
     // Find the course with this code
-    for (const auto& course : scheduler->getCourses()) {
-        if (course->getCode() == courseCode) {
-            // Add the course to the teacher
-            auto teacher = displayedTeachers[selectedTeacherIndex];
-            teacher->addCourse(course);
-            
-            // Refresh the display
-            refreshTeacherList();
-            break;
-        }
+    auto course = scheduler->findCourse(courseCode);
+    if (course) {
+        // Add the course to the teacher
+        auto teacher = displayedTeachers[selectedTeacherIndex];
+        teacher->addCourse(course);
+        
+        // Refresh the display
+        refreshTeacherList();
     }
 }
 
@@ -895,19 +905,18 @@ void SectionManagementScreen::initialize() {
     courseDropdown = new Dropdown(inputX, inputY + spacing, inputWidth, inputHeight, courseOptions);
     components.push_back(std::unique_ptr<UIComponent>(courseDropdown));
     
-    // Teacher dropdown
+    // Teacher dropdown; "TBA" leaves the section for "Assign Teachers"
     std::vector<std::string> teacherOptions;
     for (const auto& teacher : scheduler->getTeachers()) {
         teacherOptions.push_back(teacher->getId() + " - " + teacher->getName());
     }
-    if (teacherOptions.empty()) {
-        teacherOptions.push_back("No teachers available");
-    }
+    teacherOptions.push_back("TBA");
     teacherDropdown = new Dropdown(inputX, inputY + 2 * spacing, inputWidth, inputHeight, teacherOptions);
     components.push_back(std::unique_ptr<UIComponent>(teacherDropdown));
     
     // Day dropdown
-    std::vector<std::string> dayOptions = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday"};
+    std::vector<std::string> dayOptions = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday",
+                                           "Mon/Wed/Fri", "Tue/Thu"};
     dayDropdown = new Dropdown(inputX, inputY + 3 * spacing, inputWidth, inputHeight, dayOptions);
     components.push_back(std::unique_ptr<UIComponent>(dayDropdown));
     
@@ -920,9 +929,13 @@ void SectionManagementScreen::initialize() {
     components.push_back(std::unique_ptr<UIComponent>(startMinuteInput));
     
     // Duration input
-    durationInput = new TextInput(inputX, inputY + 5 * spacing, inputWidth, inputHeight, "Duration (min)");
+    durationInput = new TextInput(inputX, inputY + 5 * spacing, inputWidth / 2 - 5, inputHeight, "Min");
     components.push_back(std::unique_ptr<UIComponent>(durationInput));
     
+    // Capacity input; empty means unlimited seats
+    capacityInput = new TextInput(inputX + inputWidth / 2 + 5, inputY + 5 * spacing, inputWidth / 2 - 5, inputHeight, "Seats");
+    components.push_back(std::unique_ptr<UIComponent>(capacityInput));
+    
     // Add section button
     auto addButton = std::make_unique<Button>(
         inputX, inputY + 6 * spacing, inputWidth, inputHeight, "Add Section", GREEN
@@ -932,13 +945,43 @@ void SectionManagementScreen::initialize() {
     });
     components.push_back(std::move(addButton));
     
+    // Assign times to sections added without one
+    auto assignButton = std::make_unique<Button>(
+        inputX, inputY + 7 * spacing, inputWidth, inputHeight, "Assign Times", BLUE
+    );
+    assignButton->setOnClick([this]() {
+        assignTimeSlots();
+    });
+    components.push_back(std::move(assignButton));
+    
+    // Give qualified teachers to sections added as "TBA"
+    auto teachersButton = std::make_unique<Button>(
+        inputX, inputY + 8 * spacing, inputWidth, inputHeight, "Assign Teachers", BLUE
+    );
+    teachersButton->setOnClick([this]() {
+        assignTeachers();
+    });
+    components.push_back(std::move(teachersButton));
+    
+    // Load test: many students registering against the sections at once
+    auto rushButton = std::make_unique<Button>(
+        inputX, inputY + 9 * spacing, inputWidth, inputHeight, "Registration Rush", PURPLE
+    );
+    rushButton->setOnClick([this]() {
+        simulateRush();
+    });
+    components.push_back(std::move(rushButton));
+    
     // Refresh section list
     refreshSectionList();
     refreshDropdowns();
 }
 
 void SectionManagementScreen::update() {
-    // Nothing to update continuously
+    // Pick up the rush once its workers are done
+    if (rush.valid() && rush.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        showRushResult(rush.get());
+    }
 }
 
 void SectionManagementScreen::draw() {
@@ -950,7 +993,7 @@ void SectionManagementScreen::draw() {
     DrawText("Teacher:", 30, 210, 20, BLACK);
     DrawText("Day:", 30, 260, 20, BLACK);
     DrawText("Start Time:", 30, 310, 20, BLACK);
-    DrawText("Duration:", 30, 360, 20, BLACK);
+    DrawText("Length/Seats:", 30, 360, 20, BLACK);
     
     // Draw all UI components
     for (const auto& component : components) {
@@ -969,7 +1012,7 @@ void SectionManagementScreen::draw() {
         auto section = displayedSections[i];
         std::string sectionText = section->getId() + " - " + 
                                   section->getCourse()->getCode() + " - " +
-                                  section->getTeacher()->getName();
+                                  (section->getTeacher() ? section->getTeacher()->getName() : std::string("TBA"));
         
         DrawText(sectionText.c_str(), listX, listY + static_cast<int>(i) * itemHeight, 20, textColor);
     }
@@ -977,7 +1020,7 @@ void SectionManagementScreen::draw() {
     // If a section is selected, draw its details
     if (selectedSectionIndex >= 0 && static_cast<size_t>(selectedSectionIndex) < displayedSections.size()) {
         auto section = displayedSections[selectedSectionIndex];
-        auto timeSlot = section->getTimeSlot();
+        auto pattern = section->getMeetingPattern();
         
         // Draw section details title
         DrawText("Section Details:", 700, 70, 30, DARKBLUE);
@@ -989,14 +1032,34 @@ void SectionManagementScreen::draw() {
         DrawText(("ID: " + section->getId()).c_str(), detailX, detailY, 20, DARKGRAY);
         DrawText(("Course: " + section->getCourse()->getCode() + " - " + section->getCourse()->getName()).c_str(), 
                  detailX, detailY + 30, 20, DARKGRAY);
-        DrawText(("Teacher: " + section->getTeacher()->getName()).c_str(), 
+        DrawText(("Teacher: " + (section->getTeacher() ? section->getTeacher()->getName() : std::string("TBA"))).c_str(), 
                  detailX, detailY + 60, 20, DARKGRAY);
-        DrawText(("Time: " + timeSlot->toString()).c_str(), 
-                 detailX, detailY + 90, 20, DARKGRAY);
+        char timeText[128] = "Time: ";
+        if (pattern) {
+            pattern->format(timeText + 6, sizeof(timeText) - 6);
+        } else {
+            std::memcpy(timeText + 6, "Unassigned", sizeof("Unassigned"));
+        }
+        DrawText(timeText, detailX, detailY + 90, 20, DARKGRAY);
+        DrawText(("Room: " + (section->getRoom() ? section->getRoom()->getName() : std::string("Unassigned"))).c_str(), 
+                 detailX, detailY + 120, 20, DARKGRAY);
+        std::string seatsText = "Seats: " + std::to_string(section->getEnrolled()) + " / " +
+                                (section->getCapacity() > 0 ? std::to_string(section->getCapacity()) : std::string("unlimited"));
+        DrawText(seatsText.c_str(), detailX, detailY + 150, 20, DARKGRAY);
+    }
+    
+    // Result of the last time slot or teacher assignment, or of the last rush
+    if (!timetableStatus.empty()) {
+        DrawText(timetableStatus.c_str(), 30, 610, 18, DARKGRAY);
     }
 }
 
 ScreenState SectionManagementScreen::processInput() {
+    // The rush reads the catalog from other threads, so nothing may change it until it is done
+    if (rush.valid()) {
+        return ScreenState::SECTION_MANAGEMENT;
+    }
+    
     // Check each component for input
     for (size_t i = 0; i < components.size(); i++) {
         if (components[i]->handleInput()) {
@@ -1050,9 +1113,7 @@ void SectionManagementScreen::refreshDropdowns() {
     for (const auto& teacher : scheduler->getTeachers()) {
         teacherOptions.push_back(teacher->getId() + " - " + teacher->getName());
     }
-    if (teacherOptions.empty()) {
-        teacherOptions.push_back("No teachers available");
-    }
+    teacherOptions.push_back("TBA");
     teacherDropdown->setOptions(teacherOptions);
 }
 
@@ -1065,74 +1126,84 @@ void SectionManagementScreen::addSection() {
     std::string startHourStr = startHourInput->getText();
     std::string startMinuteStr = startMinuteInput->getText();
     std::string durationStr = durationInput->getText();
+    std::string capacityStr = capacityInput->getText();
     
     // Validate input
-    if (id.empty() || 
-        courseOption == "No courses available" || 
-        teacherOption == "No teachers available" ||
-        startHourStr.empty() || 
-        startMinuteStr.empty() || 
-        durationStr.empty()) {
+    if (id.empty() || courseOption == "No courses available") {
+        return;
+    }
+    
+    // Leaving all time fields empty adds the section without a time, for "Assign Times"
+    bool hasTime = !(startHourStr.empty() && startMinuteStr.empty() && durationStr.empty());
+    if (hasTime && (startHourStr.empty() || startMinuteStr.empty() || durationStr.empty())) {
         return;
     }
     
     // Parse time values
-    int startHour, startMinute, duration;
-    try {
-        startHour = std::stoi(startHourStr);
-        startMinute = std::stoi(startMinuteStr);
-        duration = std::stoi(durationStr);
-        
-        // Validate time values
-        if (startHour < 0 || startHour > 23 || 
-            startMinute < 0 || startMinute > 59 || 
-            duration <= 0) {
+    int startHour = 0, startMinute = 0, duration = 0;
+    if (hasTime) {
+        try {
+            startHour = std::stoi(startHourStr);
+            startMinute = std::stoi(startMinuteStr);
+            duration = std::stoi(durationStr);
+            
+            // Validate time values
+            if (startHour < 0 || startHour > 23 || 
+                startMinute < 0 || startMinute > 59 || 
+                duration <= 0) {
+                return;
+            }
+        } catch (const std::exception&) {
             return;
         }
-    } catch (const std::exception&) {
-        return;
     }
     
-    // Find the selected course
-    std::string courseCode = courseOption.substr(0, courseOption.find(" - "));
-    std::shared_ptr<Course> selectedCourse;
-    for (const auto& course : scheduler->getCourses()) {
-        if (course->getCode() == courseCode) {
-            selectedCourse = course;
-            break;
+    int capacity = 0;
+    if (!capacityStr.empty()) {
+        try {
+            capacity = std::stoi(capacityStr);
+            if (capacity < 0) {
+                return;
+            }
+        } catch (const std::exception&) {
+            return;
         }
     }
     
+    // Find the selected course
+    std::string courseCode = courseOption.substr(0, courseOption.find(" - "));
+    std::shared_ptr<Course> selectedCourse = scheduler->findCourse(courseCode);
+    
     if (!selectedCourse) {
         return;
     }
     
-    // Find the selected teacher
-    std::string teacherId = teacherOption.substr(0, teacherOption.find(" - "));
+    // Find the selected teacher; a "TBA" section has none until teachers are assigned
     std::shared_ptr<Teacher> selectedTeacher;
-    for (const auto& teacher : scheduler->getTeachers()) {
-        if (teacher->getId() == teacherId) {
-            selectedTeacher = teacher;
-            break;
+    if (teacherOption != "TBA") {
+        std::string teacherId = teacherOption.substr(0, teacherOption.find(" - "));
+        selectedTeacher = scheduler->findTeacher(teacherId);
+        
+        if (!selectedTeacher) {
+            return;
         }
     }
     
-    if (!selectedTeacher) {
-        return;
-    }
-    
-    // Create TimeSlot
-    TimeSlot::Day day;
-    if (dayOption == "Monday") day = TimeSlot::MONDAY;
-    else if (dayOption == "Tuesday") day = TimeSlot::TUESDAY;
-    else if (dayOption == "Wednesday") day = TimeSlot::WEDNESDAY;
-    else if (dayOption == "Thursday") day = TimeSlot::THURSDAY;
-    else day = TimeSlot::FRIDAY;
+    // Create the weekly meeting pattern, one bit per meeting day
+    unsigned days;
+    if (dayOption == "Monday") days = 1u << TimeSlot::MONDAY;
+    else if (dayOption == "Tuesday") days = 1u << TimeSlot::TUESDAY;
+    else if (dayOption == "Wednesday") days = 1u << TimeSlot::WEDNESDAY;
+    else if (dayOption == "Thursday") days = 1u << TimeSlot::THURSDAY;
+    else if (dayOption == "Friday") days = 1u << TimeSlot::FRIDAY;
+    else if (dayOption == "Mon/Wed/Fri") days = (1u << TimeSlot::MONDAY) | (1u << TimeSlot::WEDNESDAY) | (1u << TimeSlot::FRIDAY);
+    else days = (1u << TimeSlot::TUESDAY) | (1u << TimeSlot::THURSDAY);
     
-    auto timeSlot = std::make_shared<TimeSlot>(day, startHour, startMinute, duration);
+    auto pattern = hasTime ? std::make_shared<MeetingPattern>(days, startHour * 60 + startMinute, duration) : nullptr;
     
     // Create Section
-    auto section = std::make_shared<Section>(id, selectedCourse, selectedTeacher, timeSlot);
+    auto section = std::make_shared<Section>(id, selectedCourse, selectedTeacher, pattern);
+    section->setCapacity(capacity);
     
     // Add Section to scheduler
     scheduler->addSection(section);
@@ -1142,11 +1213,64 @@ void SectionManagementScreen::addSection() {
     startHourInput->clear();
     startMinuteInput->clear();
     durationInput->clear();
+    capacityInput->clear();
     
     // Refresh section list
     refreshSectionList();
 }
 
+void SectionManagementScreen::assignTimeSlots() {
+    TimetableResult result = scheduler->assignTimeSlots();
+    
+    timetableStatus = "Assigned " + std::to_string(result.assigned) + " sections, " +
+                      std::to_string(result.conflicts) + " clashes left";
+    
+    // Rooms follow the times, so place them again whenever times change
+    if (!scheduler->getRooms().empty()) {
+        RoomAssignmentResult rooms = scheduler->assignRooms();
+        timetableStatus += ", " + std::to_string(rooms.unassigned) + " without a room";
+    }
+    refreshSectionList();
+}
+
+void SectionManagementScreen::simulateRush() {
+    if (rush.valid()) {
+        return;
+    }
+    
+    // A few hundred students show the latencies without waiting long; the window keeps drawing meanwhile
+    RushOptions options;
+    options.students = 200;
+    std::shared_ptr<Scheduler> catalog = scheduler;
+    rush = std::async(std::launch::async, [catalog, options]() {
+        return catalog->simulateRegistrationRush(options);
+    });
+    timetableStatus = "Running a registration rush for " + std::to_string(options.students) + " students...";
+}
+
+void SectionManagementScreen::showRushResult(const RushResult& result) {
+    std::ostringstream text;
+    text.setf(std::ios::fixed);
+    text.precision(1);
+    text << "Rush: " << result.requests << " students, " << result.fullSchedules << " full, "
+         << result.partialSchedules << " partial, " << result.rejected << " none; p50 "
+         << result.latency.getPercentile(0.5) * 1000.0 << " ms, p99 "
+         << result.latency.getPercentile(0.99) * 1000.0 << " ms, "
+         << static_cast<int>(result.throughput + 0.5) << " students/s";
+    timetableStatus = text.str();
+}
+
+void SectionManagementScreen::assignTeachers() {
+    TeacherAssignmentResult result = scheduler->assignTeachers();
+    
+    timetableStatus = "Assigned teachers to " + std::to_string(result.assigned) + " of " +
+                      std::to_string(result.open) + " sections";
+    if (result.unassigned > 0) {
+        timetableStatus += ", " + std::to_string(result.unassigned) + " with no qualified teacher free";
+    }
+    refreshSectionList();
+}
+
 // RequirementManagementScreen implementation
 RequirementManagementScreen::RequirementManagementScreen(std::shared_ptr<Scheduler> scheduler)
     : Screen(scheduler), selectedRequirementIndex(-1) {}
@@ -1169,7 +1293,10 @@ void RequirementManagementScreen::initialize() {
     int spacing = 60;
     
     // Requirement type dropdown
-    std::vector<std::string> requirementTypes = {"Teacher Preference", "TimeSlot Preference"};
+    std::vector<std::string> requirementTypes = {
+        "Teacher Preference", "TimeSlot Preference",
+        "Prefer Teacher", "Avoid Teacher", "Prefer TimeSlot", "Avoid TimeSlot"
+    };
     requirementTypeDropdown = new Dropdown(inputX, inputY, inputWidth, inputHeight, requirementTypes);
     components.push_back(std::unique_ptr<UIComponent>(requirementTypeDropdown));
     
@@ -1213,9 +1340,13 @@ void RequirementManagementScreen::initialize() {
     durationInput = new TextInput(inputX, inputY + 5 * spacing, inputWidth, inputHeight, "Duration (min)");
     components.push_back(std::unique_ptr<UIComponent>(durationInput));
     
+    // Weight input (for soft Prefer/Avoid types)
+    weightInput = new TextInput(inputX, inputY + 6 * spacing, inputWidth, inputHeight, "Weight (1.0)");
+    components.push_back(std::unique_ptr<UIComponent>(weightInput));
+    
     // Add requirement button
     auto addButton = std::make_unique<Button>(
-        inputX, inputY + 6 * spacing, inputWidth, inputHeight, "Add Requirement", GREEN
+        inputX, inputY + 7 * spacing, inputWidth, inputHeight, "Add Requirement", GREEN
     );
     addButton->setOnClick([this]() {
         addRequirement();
@@ -1240,13 +1371,16 @@ void RequirementManagementScreen::draw() {
     
     // Show appropriate labels based on requirement type
     std::string typeOption = requirementTypeDropdown->getSelectedOption();
-    if (typeOption == "Teacher Preference") {
+    if (typeOption.find("Teacher") != std::string::npos) {
         DrawText("Teacher:", 30, 230, 20, BLACK);
     } else { // TimeSlot Preference
         DrawText("Day:", 30, 230, 20, BLACK);
         DrawText("Start Time:", 30, 290, 20, BLACK);
         DrawText("Duration:", 30, 350, 20, BLACK);
     }
+    if (typeOption.rfind("Prefer ", 0) == 0 || typeOption.rfind("Avoid ", 0) == 0) {
+        DrawText("Weight:", 30, 470, 20, BLACK);
+    }
     
     // Draw all UI components
     for (const auto& component : components) {
@@ -1266,6 +1400,13 @@ void RequirementManagementScreen::draw() {
         
         DrawText(reqText.c_str(), listX, listY + static_cast<int>(i) * itemHeight, 20, textColor);
     }
+    
+    // Soft preferences are listed below the hard requirements
+    const auto& preferences = scheduler->getPreferences();
+    int prefY = listY + static_cast<int>(displayedRequirements.size()) * itemHeight;
+    for (size_t i = 0; i < preferences.size(); i++) {
+        DrawText(preferences[i]->getDescription().c_str(), listX, prefY + static_cast<int>(i) * itemHeight, 20, DARKGREEN);
+    }
 }
 
 ScreenState RequirementManagementScreen::processInput() {
@@ -1340,20 +1481,29 @@ void RequirementManagementScreen::addRequirement() {
     
     // Find the selected course
     std::string courseCode = courseOption.substr(0, courseOption.find(" - "));
-    std::shared_ptr<Course> selectedCourse;
-    for (const auto& course : scheduler->getCourses()) {
-        if (course->getCode() == courseCode) {
-            selectedCourse = course;
-            break;
-        }
-    }
+    std::shared_ptr<Course> selectedCourse = scheduler->findCourse(courseCode);
     
     if (!selectedCourse) {
         return;
     }
     
+    // Prefer/Avoid types are weighted soft preferences rather than hard requirements
+    bool isSoft = requirementType.rfind("Prefer ", 0) == 0 || requirementType.rfind("Avoid ", 0) == 0;
+    bool isAvoid = requirementType.rfind("Avoid ", 0) == 0;
+    float weight = 1.0f;
+    if (isSoft && !weightInput->getText().empty()) {
+        try {
+            weight = std::stof(weightInput->getText());
+        } catch (const std::exception&) {
+            return;
+        }
+        if (weight <= 0.0f) {
+            return;
+        }
+    }
+    
     // Create appropriate requirement based on type
-    if (requirementType == "Teacher Preference") {
+    if (requirementType.find("Teacher") != std::string::npos) {
         // Get teacher
         std::string teacherOption = teacherDropdown->getSelectedOption();
         if (teacherOption == "No teachers available") {
@@ -1362,21 +1512,20 @@ void RequirementManagementScreen::addRequirement() {
         
         // Find the selected teacher
         std::string teacherId = teacherOption.substr(0, teacherOption.find(" - "));
-        std::shared_ptr<Teacher> selectedTeacher;
-        for (const auto& teacher : scheduler->getTeachers()) {
-            if (teacher->getId() == teacherId) {
-                selectedTeacher = teacher;
-                break;
-            }
-        }
+        std::shared_ptr<Teacher> selectedTeacher = scheduler->findTeacher(teacherId);
         
         if (!selectedTeacher) {
             return;
         }
         
-        // Create TeacherRequirement
-        auto requirement = std::make_shared<TeacherRequirement>(selectedCourse, selectedTeacher);
-        scheduler->addRequirement(requirement);
+        if (isSoft) {
+            auto type = isAvoid ? Preference::AVOID_TEACHER : Preference::PREFER_TEACHER;
+            scheduler->addPreference(std::make_shared<Preference>(type, selectedCourse, selectedTeacher, weight));
+        } else {
+            // Create TeacherRequirement
+            auto requirement = std::make_shared<TeacherRequirement>(selectedCourse, selectedTeacher);
+            scheduler->addRequirement(requirement);
+        }
     } 
     else { // TimeSlot Preference
         // Get time slot parameters
@@ -1417,15 +1566,21 @@ void RequirementManagementScreen::addRequirement() {
         
         auto timeSlot = std::make_shared<TimeSlot>(day, startHour, startMinute, duration);
         
-        // Create TimeSlotRequirement
-        auto requirement = std::make_shared<TimeSlotRequirement>(selectedCourse, timeSlot);
-        scheduler->addRequirement(requirement);
+        if (isSoft) {
+            auto type = isAvoid ? Preference::AVOID_TIME_SLOT : Preference::PREFER_TIME_SLOT;
+            scheduler->addPreference(std::make_shared<Preference>(type, selectedCourse, timeSlot, weight));
+        } else {
+            // Create TimeSlotRequirement
+            auto requirement = std::make_shared<TimeSlotRequirement>(selectedCourse, timeSlot);
+            scheduler->addRequirement(requirement);
+        }
     }
     
     // Clear input fields
     startHourInput->clear();
     startMinuteInput->clear();
     durationInput->clear();
+    weightInput->clear();
     
     // Refresh requirement list
     refreshRequirementList();
@@ -1433,7 +1588,8 @@ void RequirementManagementScreen::addRequirement() {
 
 // ScheduleViewerScreen implementation
 ScheduleViewerScreen::ScheduleViewerScreen(std::shared_ptr<Scheduler> scheduler)
-    : Screen(scheduler), currentScheduleIndex(0) {}
+    : Screen(scheduler), displayedScheduleCount(0), currentScheduleIndex(0), showingTradeOffs(false),
+      showingRepair(false), showingPartial(false), showingAll(false), browseFinished(false) {}
 
 void ScheduleViewerScreen::initialize() {
     // Create a back button
@@ -1459,8 +1615,8 @@ void ScheduleViewerScreen::initialize() {
         300, 20, 120, 40, "Previous", BLUE
     );
     prevButton->setOnClick([this]() {
-        if (!displayedSchedules.empty() && currentScheduleIndex > 0) {
-            currentScheduleIndex--;
+        if (displayedScheduleCount > 0 && currentScheduleIndex > 0) {
+            showSchedule(currentScheduleIndex - 1);
         }
     });
     components.push_back(std::move(prevButton));
@@ -1469,11 +1625,42 @@ void ScheduleViewerScreen::initialize() {
         430, 20, 120, 40, "Next", BLUE
     );
     nextButton->setOnClick([this]() {
-        if (!displayedSchedules.empty() && currentScheduleIndex < displayedSchedules.size() - 1) {
-            currentScheduleIndex++;
+        // While browsing, the next schedule is only produced when asked for
+        if (showingAll && currentScheduleIndex + 1 == static_cast<int>(displayedScheduleCount)) {
+            browseNext();
+        }
+        if (currentScheduleIndex + 1 < static_cast<int>(displayedScheduleCount)) {
+            showSchedule(currentScheduleIndex + 1);
         }
     });
     components.push_back(std::move(nextButton));
+    
+    // Schedules no other beats on preferences, idle time, early starts and days off at once
+    auto tradeOffButton = std::make_unique<Button>(
+        1110, 20, 150, 40, "Trade-offs", PURPLE
+    );
+    tradeOffButton->setOnClick([this]() {
+        generateTradeOffs();
+    });
+    components.push_back(std::move(tradeOffButton));
+    
+    // Every valid schedule in search order, not just the best ones kept
+    auto browseButton = std::make_unique<Button>(
+        1110, 70, 150, 40, "Browse all", DARKBLUE
+    );
+    browseButton->setOnClick([this]() {
+        browseAllSchedules();
+    });
+    components.push_back(std::move(browseButton));
+    
+    // Re-solve around the pinned classes after editing sections
+    auto repairButton = std::make_unique<Button>(
+        300, 70, 120, 40, "Re-solve", ORANGE
+    );
+    repairButton->setOnClick([this]() {
+        repairSchedule();
+    });
+    components.push_back(std::move(repairButton));
 }
 
 void ScheduleViewerScreen::update() {
@@ -1489,10 +1676,15 @@ void ScheduleViewerScreen::draw() {
     }
     
     // Draw placeholder text or schedule
-    if (displayedSchedules.empty()) {
+    if (!conflictExplanation.feasible && displayedScheduleCount == 0) {
+        drawConflictExplanation();
+    } else if (displayedScheduleCount == 0) {
         DrawText("No schedules generated yet. Press 'Generate' to create schedules.", 200, 300, 20, GRAY);
     } else {
         drawScheduleGrid();
+        if (showingPartial && !conflictExplanation.feasible) {
+            drawConflictSummary();
+        }
     }
 }
 
@@ -1506,24 +1698,320 @@ ScreenState ScheduleViewerScreen::processInput() {
             }
         }
     }
+    
+    // Clicking a class pins or unpins its section
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        auto section = findSectionAt(GetMousePosition());
+        if (section && scheduler->isPinned(*section)) {
+            scheduler->unpinSection(section);
+        } else if (section) {
+            scheduler->pinSection(section);
+        }
+    }
     return ScreenState::SCHEDULE_VIEWER;
 }
 
 void ScheduleViewerScreen::generateSchedules() {
-    // Generate schedules using the scheduler
-    scheduler->generateSchedule();
-    displayedSchedules = scheduler->getAllPossibleSchedules();
-    currentScheduleIndex = 0;
+    // Searching, counting and explaining all run on the render thread, so together
+    // they get one second; the search, partial fallback included, takes most of it
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    SolveOptions options;
+    options.timeLimitSeconds = 0.7;
+    bool satisfied = scheduler->generateSchedule(options);
+    showingTradeOffs = false;
+    showingRepair = false;
+    showingPartial = false;
+    showingAll = false;
+    browsed.clear();
+    paretoFront.clear();
+    displayedScheduleCount = scheduler->getScheduleCount();
+    showSchedule(0);
+    
+    // How many valid schedules exist in total, estimated when there are too many to count
+    // or the time is short; an explanation still to come gets the other half of what is left
+    double countSeconds = satisfied ? secondsLeft(deadline) : secondsLeft(deadline) / 2;
+    scheduleCount = scheduler->countValidSchedules(200000, countSeconds);
+    
+    // Tell the user which courses and requirements clash instead of showing nothing,
+    // in whatever is left of the second
+    ConflictOptions conflictOptions;
+    conflictOptions.timeLimitSeconds = secondsLeft(deadline);
+    conflictExplanation = satisfied ? ConflictExplanation() : scheduler->explainConflicts(conflictOptions);
+    
+    // Failing that, show the schedule keeping the most credits, with the clash listed under it;
+    // one placing nothing leaves the whole screen to the explanation
+    auto partial = satisfied ? nullptr : scheduler->getCurrentSchedule();
+    showingPartial = partial && !partial->getSections().empty();
+    if (showingPartial) {
+        displayedScheduleCount = 1;
+        showSchedule(0);
+    } else if (!conflictExplanation.feasible) {
+        displayedScheduleCount = 0;
+        displayedSchedule = nullptr;
+    }
+}
+
+void ScheduleViewerScreen::generateTradeOffs() {
+    // Same one second for the front, the count and any explanation together; a front
+    // cut short is still free of dominated schedules found so far
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    ParetoOptions options;
+    options.timeLimitSeconds = 0.7;
+    paretoFront = scheduler->generateParetoFront(options);
+    showingTradeOffs = true;
+    showingRepair = false;
+    showingPartial = false;
+    showingAll = false;
+    browsed.clear();
+    displayedScheduleCount = paretoFront.size();
+    showSchedule(0);
+    
+    double countSeconds = paretoFront.empty() ? secondsLeft(deadline) / 2 : secondsLeft(deadline);
+    scheduleCount = scheduler->countValidSchedules(200000, countSeconds);
+    ConflictOptions conflictOptions;
+    conflictOptions.timeLimitSeconds = secondsLeft(deadline);
+    conflictExplanation = paretoFront.empty() ? scheduler->explainConflicts(conflictOptions) : ConflictExplanation();
+}
+
+void ScheduleViewerScreen::browseAllSchedules() {
+    // The stream keeps its own copy of the search, so it holds nothing but the pages seen
+    browseStream = scheduler->streamSchedules();
+    browsed.clear();
+    browseFinished = false;
+    showingAll = true;
+    showingTradeOffs = false;
+    showingRepair = false;
+    showingPartial = false;
+    paretoFront.clear();
+    conflictExplanation = ConflictExplanation();
+    
+    browseNext();
+    displayedScheduleCount = browsed.size();
+    showSchedule(0);
+    scheduleCount = scheduler->countValidSchedules(200000, 1.0);
+}
+
+bool ScheduleViewerScreen::browseNext() {
+    std::shared_ptr<Schedule> schedule;
+    if (browseFinished || !browseStream.next(schedule)) {
+        browseFinished = true;
+        return false;
+    }
+    browsed.push_back(schedule);
+    displayedScheduleCount = browsed.size();
+    return true;
+}
+
+void ScheduleViewerScreen::repairSchedule() {
+    // Nothing on screen to start from means a plain generation
+    if (!displayedSchedule) {
+        generateSchedules();
+        return;
+    }
+    
+    RepairOptions options;
+    options.timeLimitSeconds = 1.0;
+    Schedule previous = *displayedSchedule;
+    scheduler->repairSchedule(previous, options);
+    if (!scheduler->getLastRepairResult().complete) {
+        // Keep showing the old schedule; the status line says the repair failed
+        showingRepair = true;
+        return;
+    }
+    
+    showingTradeOffs = false;
+    showingRepair = true;
+    showingPartial = false;
+    paretoFront.clear();
+    showingAll = false;
+    browsed.clear();
+    displayedScheduleCount = scheduler->getScheduleCount();
+    showSchedule(0);
+}
+
+std::shared_ptr<Section> ScheduleViewerScreen::findSectionAt(Vector2 position) const {
+    if (!displayedSchedule) {
+        return nullptr;
+    }
+    
+    // Same geometry as drawScheduleGrid
+    const int gridStartX = 100;
+    const int gridStartY = 120;
+    const int timeColWidth = 100;
+    const int dayColWidth = 200;
+    const int rowHeight = 60;
+    
+    for (const auto& section : displayedSchedule->getSections()) {
+        auto pattern = section->getMeetingPattern();
+        if (!pattern) continue;
+        
+        for (PackedTimeSlot slot : pattern->getMeetings()) {
+            if (slot.getStartHour() < 8 || slot.getStartHour() >= 17 || slot.getDay() > TimeSlot::FRIDAY) {
+                continue;
+            }
+            float classX = gridStartX + timeColWidth + slot.getDay() * dayColWidth;
+            float classY = gridStartY + rowHeight + (slot.getStartMinute() - 8 * 60) / 60.0f * rowHeight;
+            float height = std::max(slot.getDurationMinutes() / 60.0f * rowHeight, 30.0f);
+            if (position.x >= classX + 2 && position.x <= classX + dayColWidth - 2 &&
+                position.y >= classY && position.y <= classY + height) {
+                return section;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ScheduleViewerScreen::showSchedule(int index) {
+    currentScheduleIndex = index;
+    if (index >= static_cast<int>(displayedScheduleCount)) {
+        displayedSchedule = nullptr;
+    } else if (showingTradeOffs) {
+        displayedSchedule = paretoFront[index].schedule;
+    } else if (showingAll) {
+        displayedSchedule = browsed[index];
+    } else if (showingPartial) {
+        displayedSchedule = scheduler->getCurrentSchedule();
+    } else {
+        displayedSchedule = scheduler->getSchedule(index);
+    }
+}
+
+void ScheduleViewerScreen::drawConflictExplanation() {
+    DrawText("No schedule satisfies all requirements. These cannot all hold together:", 100, 130, 20, MAROON);
+    
+    int y = 170;
+    for (const auto& course : conflictExplanation.courses) {
+        DrawText(("Course " + course->getCode() + ": " + course->getName()).c_str(), 120, y, 20, BLACK);
+        y += 30;
+    }
+    for (const auto& requirement : conflictExplanation.requirements) {
+        DrawText(requirement->getDescription().c_str(), 120, y, 20, BLACK);
+        y += 30;
+    }
+    
+    if (conflictExplanation.minimal) {
+        DrawText("Remove or change any one of them to get a schedule.", 100, y + 10, 20, GRAY);
+    } else {
+        DrawText("Time budget hit: this set may not be minimal, so not every one of them is needed for the clash.",
+                 100, y + 10, 20, ORANGE);
+    }
+}
+
+void ScheduleViewerScreen::drawConflictSummary() {
+    // Names only, wrapped across the bottom of the grid so the partial schedule stays readable
+    std::vector<std::string> items;
+    for (const auto& course : conflictExplanation.courses) {
+        items.push_back("Course " + course->getCode());
+    }
+    for (const auto& requirement : conflictExplanation.requirements) {
+        items.push_back(requirement->getDescription());
+    }
+    
+    const int left = 110;
+    const int right = 1190;
+    const int fontSize = 18;
+    std::vector<std::string> lines(1, conflictExplanation.minimal ? "Cannot all hold together: " :
+                                      "Cannot all hold together (may not be minimal): ");
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::string item = items[i] + (i + 1 < items.size() ? ", " : "");
+        if (MeasureText((lines.back() + item).c_str(), fontSize) > right - left && !lines.back().empty()) {
+            lines.push_back("");
+        }
+        lines.back() += item;
+    }
+    
+    int height = static_cast<int>(lines.size()) * (fontSize + 4) + 12;
+    int top = 710 - height;
+    DrawRectangle(left - 10, top, right - left + 20, height, Fade(RAYWHITE, 0.9f));
+    DrawRectangleLines(left - 10, top, right - left + 20, height, MAROON);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        DrawText(lines[i].c_str(), left, top + 6 + static_cast<int>(i) * (fontSize + 4), fontSize, MAROON);
+    }
 }
 
 void ScheduleViewerScreen::drawScheduleGrid() {
-    if (displayedSchedules.empty() || currentScheduleIndex >= displayedSchedules.size()) {
+    if (!displayedSchedule) {
         return;
     }
     
     // Draw schedule info
-    DrawText(("Schedule #" + std::to_string(currentScheduleIndex + 1) + " of " + 
-             std::to_string(displayedSchedules.size())).c_str(), 560, 30, 20, BLACK);
+    if (showingPartial) {
+        DrawText("Best partial schedule", 560, 30, 20, MAROON);
+    } else if (showingAll) {
+        // How many there are is only known once the stream has run dry
+        std::string browseText = "Valid schedule #" + std::to_string(currentScheduleIndex + 1);
+        if (browseFinished) {
+            browseText += " of " + std::to_string(displayedScheduleCount);
+        }
+        DrawText(browseText.c_str(), 560, 30, 20, BLACK);
+    } else {
+        DrawText(((showingTradeOffs ? "Trade-off #" : "Schedule #") + std::to_string(currentScheduleIndex + 1) + " of " + 
+                 std::to_string(displayedScheduleCount)).c_str(), 560, 30, 20, BLACK);
+    }
+    
+    // Draw how many valid schedules exist, with thousands separators
+    std::string countText;
+    if (scheduleCount.count < 1e18) {
+        countText = std::to_string(static_cast<unsigned long long>(scheduleCount.count + 0.5));
+        for (int i = static_cast<int>(countText.size()) - 3; i > 0; i -= 3) {
+            countText.insert(i, ",");
+        }
+    } else {
+        std::ostringstream scientific;
+        scientific.precision(2);
+        scientific << std::scientific << scheduleCount.count;
+        countText = scientific.str();
+    }
+    countText = (scheduleCount.exact ? "Valid schedules: " : "Valid schedules: about ") + countText;
+    DrawText(countText.c_str(), 560, 55, 18, DARKGRAY);
+    
+    // Draw the preference score of the displayed schedule
+    int scorePercent = static_cast<int>(scheduler->getScheduleScore(*displayedSchedule) * 100.0f + 0.5f);
+    DrawText(("Preference score: " + std::to_string(scorePercent) + "%").c_str(), 800, 30, 20, DARKGREEN);
+    
+    // Idle time and free days of the displayed week
+    CompactnessReport compactnessReport = showingTradeOffs ? paretoFront[currentScheduleIndex].compactness :
+        scheduler->getScheduleCompactness(*displayedSchedule);
+    std::string compactText = "Idle " + std::to_string(compactnessReport.idleMinutes / 60) + "h " +
+        std::to_string(compactnessReport.idleMinutes % 60) + "m, " +
+        std::to_string(compactnessReport.daysOff) + " days off";
+    if (showingTradeOffs) {
+        compactText += ", " + std::to_string(compactnessReport.earlyStarts) + " early starts";
+    }
+    if (showingPartial) {
+        // The courses that did not fit take the place of the compactness summary
+        compactText = "Dropped:";
+        for (const auto& course : scheduler->getCourses()) {
+            if (displayedSchedule->getSectionsForCourse(course->getCode()).empty()) {
+                compactText += " " + course->getCode();
+            }
+        }
+    }
+    DrawText(compactText.c_str(), 800, 80, 18, DARKGRAY);
+    
+    // Show whether the search finished or stopped at its budget
+    if (showingRepair) {
+        const RepairResult& repair = scheduler->getLastRepairResult();
+        std::string repairText = !repair.complete ? "Re-solve failed: pinned classes clash or a course has no room" :
+            "Re-solved, " + std::to_string(repair.changed) + " course(s) changed";
+        DrawText(repairText.c_str(), 800, 55, 18, repair.complete ? DARKGREEN : MAROON);
+    } else if (showingPartial) {
+        const PartialResult& partial = scheduler->getLastPartialResult();
+        std::string partialText = "No full schedule: " + std::to_string(static_cast<int>(partial.placedWeight)) +
+            " of " + std::to_string(static_cast<int>(partial.totalWeight)) + " credits placed";
+        DrawText(partialText.c_str(), 800, 55, 18, MAROON);
+    } else if (showingAll) {
+        DrawText("Every valid schedule, in search order", 800, 55, 18, DARKGRAY);
+    } else if (showingTradeOffs) {
+        bool complete = scheduler->getLastParetoResult().complete;
+        DrawText(complete ? "Complete trade-off front" : "Time budget hit, front may be partial",
+                 800, 55, 18, complete ? DARKGREEN : ORANGE);
+    } else {
+        const SolveStats& stats = scheduler->getLastSolveStats();
+        std::string solveText = stats.optimal ? "Best possible" :
+            "Time budget hit, gap " + std::to_string(static_cast<int>(stats.gap * 100.0f + 0.5f)) + "%";
+        DrawText(solveText.c_str(), 800, 55, 18, stats.optimal ? DARKGREEN : ORANGE);
+    }
     
     // Grid constants
     const int gridStartX = 100;
@@ -1554,6 +2042,20 @@ void ScheduleViewerScreen::drawScheduleGrid() {
     // Draw header text "Schedule"
     DrawText("Schedule", gridStartX, gridStartY - 40, 30, DARKBLUE);
     
+    // Hovering a class lists the sections that would do just as well in its place
+    std::string hintText = "Click a class to pin it for Re-solve";
+    auto hovered = findSectionAt(GetMousePosition());
+    if (hovered) {
+        auto equivalent = scheduler->getEquivalentSections(*hovered);
+        if (!equivalent.empty()) {
+            hintText = hovered->getCourse()->getCode() + " " + hovered->getId() + " could also be:";
+            for (const auto& other : equivalent) {
+                hintText += " " + other->getId();
+            }
+        }
+    }
+    DrawText(hintText.c_str(), 430, gridStartY - 32, 16, GRAY);
+    
     // Draw grid lines and headers
     
     // Draw time column headers (left column)
@@ -1587,79 +2089,71 @@ void ScheduleViewerScreen::drawScheduleGrid() {
     }
     
     // Draw classes on the grid
-    auto schedule = displayedSchedules[currentScheduleIndex];
+    auto schedule = displayedSchedule;
     for (const auto& section : schedule->getSections()) {
-        auto timeSlot = section->getTimeSlot();
-        auto startTime = timeSlot->getStartHour() * 60 + timeSlot->getStartMinute();
-        auto duration = timeSlot->getDurationMinutes();
-        auto day = timeSlot->getDay();
+        auto pattern = section->getMeetingPattern();
+        if (!pattern) continue;
         
-        // Skip if outside our grid
-        if (timeSlot->getStartHour() < 8 || timeSlot->getStartHour() >= 17 || day > TimeSlot::FRIDAY) {
-            continue;
+        // One block per meeting of the week
+        for (PackedTimeSlot slot : pattern->getMeetings()) {
+            int duration = slot.getDurationMinutes();
+            int day = slot.getDay();
+            
+            // Skip if outside our grid
+            if (slot.getStartHour() < 8 || slot.getStartHour() >= 17 || day > TimeSlot::FRIDAY) {
+                continue;
+            }
+            
+            // Calculate position in grid
+            int dayIndex = day;
+            int startHour = slot.getStartHour();
+            int startMin = slot.getStartMinute() % 60;
+            int startRowIndex = startHour - 8; // Grid starts at 8AM
+            
+            // Calculate fractional positioning for better precision
+            float startYOffset = startMin / 60.0f * rowHeight;
+            float durationHeight = (duration / 60.0f) * rowHeight;
+            
+            // Ensure minimum height
+            durationHeight = std::max(durationHeight, 30.0f);
+            
+            // Draw class block
+            int classX = gridStartX + timeColWidth + dayIndex * dayColWidth;
+            int classY = gridStartY + rowHeight + startRowIndex * rowHeight + startYOffset;
+            
+            // Draw class block, pinned classes stand out
+            bool pinned = scheduler->isPinned(*section);
+            DrawRectangle(classX + 2, classY, dayColWidth - 4, durationHeight, pinned ? GOLD : classBlockColor);
+            
+            // Format time string
+            char timeText[TimeFormat::CAPACITY];
+            TimeFormat::formatSlot(slot, TimeFormat::COMPACT, timeText, sizeof(timeText));
+            
+            // Draw text within the class block
+            int textY = classY + 5;
+            
+            // Course code and section
+            std::string courseText = section->getCourse()->getCode() + " - " + section->getId();
+            DrawText(courseText.c_str(), classX + 10, textY, 18, BLACK);
+            textY += 20;
+            
+            // Class type (assuming a lecture for simplicity), and how many sections are interchangeable with it
+            std::string typeText = pinned ? "Lecture (pinned)" : "Lecture";
+            size_t alike = scheduler->getEquivalentSections(*section).size();
+            if (alike > 0) {
+                typeText += " +" + std::to_string(alike) + " alike";
+            }
+            DrawText(typeText.c_str(), classX + 10, textY, 16, BLACK);
+            textY += 16;
+            
+            // Time text
+            DrawText(timeText, classX + 10, textY, 16, BLACK);
+            textY += 16;
+            
+            // Room, once rooms have been assigned
+            std::string locationText = section->getRoom() ? section->getRoom()->getName() : "HU City Campus";
+            DrawText(locationText.c_str(), classX + 10, textY, 14, BLACK);
         }
-        
-        // Calculate position in grid
-        int dayIndex = static_cast<int>(day);
-        int startHour = timeSlot->getStartHour();
-        int startMin = timeSlot->getStartMinute();
-        int startRowIndex = startHour - 8; // Grid starts at 8AM
-        
-        // Calculate fractional positioning for better precision
-        float startYOffset = startMin / 60.0f * rowHeight;
-        float durationHeight = (duration / 60.0f) * rowHeight;
-        
-        // Ensure minimum height
-        durationHeight = std::max(durationHeight, 30.0f);
-        
-        // Draw class block
-        int classX = gridStartX + timeColWidth + dayIndex * dayColWidth;
-        int classY = gridStartY + rowHeight + startRowIndex * rowHeight + startYOffset;
-        
-        // Draw class block
-        DrawRectangle(classX + 2, classY, dayColWidth - 4, durationHeight, classBlockColor);
-        
-        // Format time string
-        char startTimeStr[20];
-        char endTimeStr[20];
-        
-        int endHour = (startTime + duration) / 60;
-        int endMin = (startTime + duration) % 60;
-        
-        bool startPM = startHour >= 12;
-        bool endPM = endHour >= 12;
-        
-        // Convert to 12-hour format
-        int startHour12 = startHour > 12 ? startHour - 12 : (startHour == 0 ? 12 : startHour);
-        int endHour12 = endHour > 12 ? endHour - 12 : (endHour == 0 ? 12 : endHour);
-        
-        sprintf(startTimeStr, "%d:%02dAM", startHour12, startMin);
-        sprintf(endTimeStr, "%d:%02dAM", endHour12, endMin);
-        
-        if (startPM) strcpy(&startTimeStr[strlen(startTimeStr)-2], "PM");
-        if (endPM) strcpy(&endTimeStr[strlen(endTimeStr)-2], "PM");
-        
-        // Draw text within the class block
-        int textY = classY + 5;
-        
-        // Course code and section
-        std::string courseText = section->getCourse()->getCode() + " - " + section->getId();
-        DrawText(courseText.c_str(), classX + 10, textY, 18, BLACK);
-        textY += 20;
-        
-        // Class type (assuming a lecture for simplicity)
-        std::string typeText = "Lecture";
-        DrawText(typeText.c_str(), classX + 10, textY, 16, BLACK);
-        textY += 16;
-        
-        // Time text
-        std::string timeText = std::string(startTimeStr) + " - " + std::string(endTimeStr);
-        DrawText(timeText.c_str(), classX + 10, textY, 16, BLACK);
-        textY += 16;
-        
-        // Teacher name
-        std::string locationText = "HU City Campus";
-        DrawText(locationText.c_str(), classX + 10, textY, 14, BLACK);
     }
 }
 